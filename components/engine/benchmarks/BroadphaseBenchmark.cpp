@@ -0,0 +1,72 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include <cstdio>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "TPool.h"
+#include "physics/SweepAndPrune.h"
+
+using namespace vis;
+
+//Bodies spread over a flat world moving a little every frame, the coherent case the incremental sort is built for.
+int main()
+{
+    constexpr int FRAMES = 120;
+    constexpr float DT = 1.0f / 60.0f;
+
+    TPool::initialize();
+
+    for(size_t count : { 10000, 50000, 100000 })
+    {
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<float> ground(0.0f, 600.0f);
+        std::uniform_real_distribution<float> height(0.0f, 20.0f);
+        std::uniform_real_distribution<float> speed(-4.0f, 4.0f);
+
+        std::vector<glm::vec3> positions(count);
+        std::vector<glm::vec3> velocities(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            positions[i] = glm::vec3(ground(generator), height(generator), ground(generator));
+            velocities[i] = glm::vec3(speed(generator), 0.0f, speed(generator));
+        }
+
+        SweepAndPrune broadphase;
+        double best = 1e30;
+        double total = 0.0;
+        size_t pairs = 0;
+
+        for(int frame = 0; frame < FRAMES; frame++)
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                positions[i] += velocities[i] * DT;
+                broadphase.update(make_entity_id(static_cast<std::uint32_t>(i), 0), AABB{ positions[i] - 0.7f, positions[i] + 0.7f });
+            }
+
+            auto begin = std::chrono::high_resolution_clock::now();
+            pairs = broadphase.update_pairs().size();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            //First frame sorts from scratch, it is not part of the steady state.
+            if(frame > 0)
+            {
+                double ms = std::chrono::duration<double, std::milli>(end - begin).count();
+                best = std::min(best, ms);
+                total += ms;
+            }
+        }
+
+        std::printf("%8zu bodies: best %8.3f ms, average %8.3f ms, %zu pairs, sweep axis %d\n",
+                    count, best, total / (FRAMES - 1), pairs, broadphase.get_sweep_axis());
+    }
+
+    TPool::shutdown();
+
+    return 0;
+}
@@ -0,0 +1,346 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <new>
+#include <algorithm>
+
+#include "ecs/MainManager.h"
+
+using namespace vis;
+
+//Defined by the editor in the application, the benchmark links the ECS on its own.
+std::shared_ptr<MainManager> MainManager::m_instance;
+
+//Heap bytes currently allocated through the global operator new, used for the memory footprint. Every block
+//carries its size in front of it so deletes without a size can subtract it as well. Over aligned blocks, like
+//archetype chunks, also keep the pointer malloc returned right before the size.
+namespace
+{
+    constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+    static_assert(ALLOCATION_HEADER >= sizeof(size_t) + sizeof(void*));
+
+    std::atomic<size_t> g_live_bytes{ 0 };
+
+    void* counted_allocate(size_t a_size)
+    {
+        void* block = std::malloc(a_size + ALLOCATION_HEADER);
+        if(!block)
+        {
+            throw std::bad_alloc();
+        }
+
+        *static_cast<size_t*>(block) = a_size;
+        g_live_bytes.fetch_add(a_size, std::memory_order_relaxed);
+
+        return static_cast<char*>(block) + ALLOCATION_HEADER;
+    }
+
+    void counted_free(void* a_pointer)
+    {
+        if(!a_pointer)
+        {
+            return;
+        }
+
+        void* block = static_cast<char*>(a_pointer) - ALLOCATION_HEADER;
+        g_live_bytes.fetch_sub(*static_cast<size_t*>(block), std::memory_order_relaxed);
+        std::free(block);
+    }
+
+    void* counted_allocate_aligned(size_t a_size, std::align_val_t a_alignment)
+    {
+        size_t alignment = std::max(static_cast<size_t>(a_alignment), ALLOCATION_HEADER);
+        void* block = std::malloc(a_size + alignment + ALLOCATION_HEADER);
+        if(!block)
+        {
+            throw std::bad_alloc();
+        }
+
+        auto address = reinterpret_cast<std::uintptr_t>(block) + ALLOCATION_HEADER;
+        auto* aligned = reinterpret_cast<char*>((address + alignment - 1) / alignment * alignment);
+
+        *reinterpret_cast<size_t*>(aligned - sizeof(size_t)) = a_size;
+        *reinterpret_cast<void**>(aligned - sizeof(size_t) - sizeof(void*)) = block;
+        g_live_bytes.fetch_add(a_size, std::memory_order_relaxed);
+
+        return aligned;
+    }
+
+    void counted_free_aligned(void* a_pointer)
+    {
+        if(!a_pointer)
+        {
+            return;
+        }
+
+        auto* aligned = static_cast<char*>(a_pointer);
+        g_live_bytes.fetch_sub(*reinterpret_cast<size_t*>(aligned - sizeof(size_t)), std::memory_order_relaxed);
+        std::free(*reinterpret_cast<void**>(aligned - sizeof(size_t) - sizeof(void*)));
+    }
+}
+
+void* operator new(size_t a_size) { return counted_allocate(a_size); }
+void* operator new[](size_t a_size) { return counted_allocate(a_size); }
+void operator delete(void* a_pointer) noexcept { counted_free(a_pointer); }
+void operator delete[](void* a_pointer) noexcept { counted_free(a_pointer); }
+void operator delete(void* a_pointer, size_t) noexcept { counted_free(a_pointer); }
+void operator delete[](void* a_pointer, size_t) noexcept { counted_free(a_pointer); }
+void* operator new(size_t a_size, std::align_val_t a_alignment) { return counted_allocate_aligned(a_size, a_alignment); }
+void* operator new[](size_t a_size, std::align_val_t a_alignment) { return counted_allocate_aligned(a_size, a_alignment); }
+void operator delete(void* a_pointer, std::align_val_t) noexcept { counted_free_aligned(a_pointer); }
+void operator delete[](void* a_pointer, std::align_val_t) noexcept { counted_free_aligned(a_pointer); }
+void operator delete(void* a_pointer, size_t, std::align_val_t) noexcept { counted_free_aligned(a_pointer); }
+void operator delete[](void* a_pointer, size_t, std::align_val_t) noexcept { counted_free_aligned(a_pointer); }
+
+namespace
+{
+    struct Position
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Velocity
+    {
+        float m_x, m_y, m_z;
+    };
+
+    struct Health
+    {
+        int m_value;
+    };
+
+    //Only there so signature changes have system membership to update.
+    class MovementSystem : public System {};
+    class HealthSystem : public System {};
+
+    //Per operation cost at the largest count is reported against this one, so costs growing with the world show up.
+    constexpr size_t SCALING_BASE_COUNT = 100000;
+
+    struct Result
+    {
+        std::string m_name;
+        double      m_ms;
+        size_t      m_operations;
+    };
+
+    const char* get_backend_name(StorageBackend a_backend)
+    {
+        return a_backend == StorageBackend::ARCHETYPE ? "archetype" : "sparse_set";
+    }
+
+    //Fresh world with the benchmark components and systems, signatures are set before any entity exists.
+    void init_world(StorageBackend a_backend)
+    {
+        MainManager::init(a_backend);
+        auto main_manager = MainManager::get_instance();
+
+        main_manager->register_component<Position>();
+        main_manager->register_component<Velocity>();
+        main_manager->register_component<Health>();
+
+        main_manager->register_system<MovementSystem>();
+        main_manager->register_system<HealthSystem>();
+
+        Signature movement;
+        movement.set(main_manager->get_component_type<Position>());
+        movement.set(main_manager->get_component_type<Velocity>());
+        main_manager->set_system_signature<MovementSystem>(movement);
+
+        Signature health;
+        health.set(main_manager->get_component_type<Position>());
+        health.set(main_manager->get_component_type<Health>());
+        main_manager->set_system_signature<HealthSystem>(health);
+    }
+
+    template<typename F>
+    double time_ms(F&& a_func)
+    {
+        auto begin = std::chrono::high_resolution_clock::now();
+        a_func();
+        auto end = std::chrono::high_resolution_clock::now();
+
+        return std::chrono::duration<double, std::milli>(end - begin).count();
+    }
+
+    void keep_best(std::vector<Result>& a_results, const std::string& a_name, double a_ms, size_t a_operations)
+    {
+        for(Result& result : a_results)
+        {
+            if(result.m_name == a_name)
+            {
+                result.m_ms = std::min(result.m_ms, a_ms);
+                return;
+            }
+        }
+
+        a_results.push_back({ a_name, a_ms, a_operations });
+    }
+
+    //One pass over a fresh world, every timing lands in a_results keeping the best one over runs.
+    size_t run_once(StorageBackend a_backend, size_t a_count, std::vector<Result>& a_results)
+    {
+        std::mt19937 generator(42);
+
+        init_world(a_backend);
+        auto main_manager = MainManager::get_instance();
+        size_t base_bytes = g_live_bytes.load();
+        std::vector<EntityID> ids(a_count);
+
+        keep_best(a_results, "create_entity", time_ms([&]() {
+            for(size_t i = 0; i < a_count; i++)
+            {
+                ids[i] = main_manager->create_entity();
+            }
+        }), a_count);
+
+        keep_best(a_results, "add_component", time_ms([&]() {
+            for(size_t i = 0; i < a_count; i++)
+            {
+                main_manager->add_component(ids[i], Position{ float(i), 0.0f, 0.0f });
+                main_manager->add_component(ids[i], Velocity{ 1.0f, 1.0f, 1.0f });
+            }
+        }), 2 * a_count);
+
+        size_t footprint = g_live_bytes.load() - base_bytes;
+
+        float sink = 0.0f;
+        keep_best(a_results, "iterate_single", time_ms([&]() {
+            main_manager->view<const Position>().each([&sink](EntityID, const Position& a_position) {
+                sink += a_position.m_x;
+            });
+        }), a_count);
+
+        keep_best(a_results, "iterate_multi", time_ms([&]() {
+            main_manager->view<Position, const Velocity>().each([](EntityID, Position& a_position, const Velocity& a_velocity) {
+                a_position.m_x += a_velocity.m_x;
+                a_position.m_y += a_velocity.m_y;
+                a_position.m_z += a_velocity.m_z;
+            });
+        }), a_count);
+
+        //Health joins and leaves random entities, each change moves them in and out of HealthSystem.
+        //Structural timings include the flush applying the changes to system entity lists.
+        std::vector<EntityID> churned(a_count);
+        std::uniform_int_distribution<size_t> pick(0, a_count - 1);
+        for(EntityID& id : churned)
+        {
+            id = ids[pick(generator)];
+        }
+
+        keep_best(a_results, "signature_churn", time_ms([&]() {
+            for(EntityID id : churned)
+            {
+                if(main_manager->get_entity_signature(id).test(main_manager->get_component_type<Health>()))
+                {
+                    main_manager->remove_component<Health>(id);
+                }
+                else
+                {
+                    main_manager->add_component(id, Health{ 100 });
+                }
+            }
+            main_manager->flush_commands();
+        }), a_count);
+
+        std::shuffle(ids.begin(), ids.end(), generator);
+        keep_best(a_results, "remove_component", time_ms([&]() {
+            for(EntityID id : ids)
+            {
+                main_manager->remove_component<Velocity>(id);
+            }
+            main_manager->flush_commands();
+        }), a_count);
+
+        keep_best(a_results, "destroy_entity", time_ms([&]() {
+            for(EntityID id : ids)
+            {
+                main_manager->destroy_entity(id);
+            }
+            main_manager->flush_commands();
+        }), a_count);
+
+        keep_best(a_results, "create_entities_bulk", time_ms([&]() {
+            main_manager->create_entities(a_count, Position{ 0.0f, 0.0f, 0.0f }, Velocity{ 1.0f, 1.0f, 1.0f });
+        }), a_count);
+
+        if(sink == 1.0f)
+        {
+            std::fprintf(stderr, " ");
+        }
+
+        return footprint;
+    }
+}
+
+//Headless ECS throughput and memory at growing entity counts, JSON on stdout. Optional argument is the number
+//of runs per count, the best time of all runs is reported. Every operation also gets a "scaling" entry comparing
+//its cost per operation at the largest count with the one at SCALING_BASE_COUNT, close to 1 when it does not
+//depend on the number of entities.
+int main(int argc, char** argv)
+{
+    int runs = argc > 1 ? std::max(1, std::atoi(argv[1])) : 3;
+
+    std::printf("{\n  \"benchmark\": \"ecs\",\n  \"runs\": %d,\n  \"results\": [", runs);
+
+    bool first = true;
+    for(StorageBackend backend : { StorageBackend::SPARSE_SET, StorageBackend::ARCHETYPE })
+    {
+        std::vector<Result> base_results;
+        std::vector<Result> results;
+        size_t largest_count = 0;
+
+        for(size_t count : { 1000, 10000, 100000, 1000000 })
+        {
+            results.clear();
+            largest_count = count;
+            size_t footprint = 0;
+
+            for(int run = 0; run < runs; run++)
+            {
+                footprint = run_once(backend, count, results);
+            }
+
+            for(const Result& result : results)
+            {
+                std::printf("%s\n    { \"backend\": \"%s\", \"entities\": %zu, \"name\": \"%s\", \"operations\": %zu, \"ms\": %.4f, \"ns_per_op\": %.2f, \"ops_per_s\": %.0f }",
+                            first ? "" : ",", get_backend_name(backend), count, result.m_name.c_str(), result.m_operations, result.m_ms,
+                            result.m_ms * 1e6 / double(result.m_operations), double(result.m_operations) / (result.m_ms * 1e-3));
+                first = false;
+            }
+
+            std::printf(",\n    { \"backend\": \"%s\", \"entities\": %zu, \"name\": \"memory\", \"bytes\": %zu, \"bytes_per_entity\": %.1f }",
+                        get_backend_name(backend), count, footprint, double(footprint) / double(count));
+            std::fflush(stdout);
+
+            if(count == SCALING_BASE_COUNT)
+            {
+                base_results = results;
+            }
+        }
+
+        for(const Result& base : base_results)
+        {
+            auto result = std::find_if(results.begin(), results.end(), [&base](const Result& a_result) { return a_result.m_name == base.m_name; });
+            double base_ns = base.m_ms * 1e6 / double(base.m_operations);
+            double ns = result->m_ms * 1e6 / double(result->m_operations);
+
+            std::printf(",\n    { \"backend\": \"%s\", \"name\": \"scaling\", \"operation\": \"%s\", \"base_entities\": %zu, \"base_ns_per_op\": %.2f, "
+                        "\"entities\": %zu, \"ns_per_op\": %.2f, \"ratio\": %.2f }",
+                        get_backend_name(backend), base.m_name.c_str(), SCALING_BASE_COUNT, base_ns, largest_count, ns, ns / base_ns);
+        }
+        std::fflush(stdout);
+    }
+
+    std::printf("\n  ]\n}\n");
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "math/TransformKernel.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+using namespace vis;
+
+namespace
+{
+    //Matrix chain the renderer used before the kernel, kept as the reference.
+    glm::mat4 compose_reference(const Transform& a_transform)
+    {
+        glm::mat4 transform_mat = glm::translate(glm::mat4(1.0f), a_transform.m_position);
+        transform_mat = glm::rotate(transform_mat, glm::radians(a_transform.m_rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+        transform_mat = glm::rotate(transform_mat, glm::radians(a_transform.m_rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+        transform_mat = glm::rotate(transform_mat, glm::radians(a_transform.m_rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+
+        return glm::scale(transform_mat, a_transform.m_scale);
+    }
+
+    template<typename F>
+    double best_of(int a_runs, F&& a_func)
+    {
+        double best = 1e30;
+        for(int run = 0; run < a_runs; run++)
+        {
+            auto begin = std::chrono::high_resolution_clock::now();
+            a_func();
+            auto end = std::chrono::high_resolution_clock::now();
+
+            best = std::min(best, std::chrono::duration<double, std::milli>(end - begin).count());
+        }
+
+        return best;
+    }
+}
+
+int main()
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> angle(-360.0f, 360.0f);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+    for(size_t count : { 10000, 100000, 1000000 })
+    {
+        std::vector<Transform> transforms(count);
+        for(Transform& transform : transforms)
+        {
+            transform.m_position = glm::vec3(position(generator), position(generator), position(generator));
+            transform.m_rotation = glm::vec3(angle(generator), angle(generator), angle(generator));
+            transform.m_scale = glm::vec3(scale(generator), scale(generator), scale(generator));
+        }
+
+        std::vector<glm::mat4> reference(count);
+        std::vector<glm::mat4> batched(count);
+
+        double reference_ms = best_of(5, [&]() {
+            for(size_t i = 0; i < count; i++)
+            {
+                reference[i] = compose_reference(transforms[i]);
+            }
+        });
+        double batched_ms = best_of(5, [&]() {
+            compose_model_matrices(transforms.data(), count, batched.data());
+        });
+
+        //Error relative to the magnitude of each column, so large scales or positions don't dominate.
+        float max_error = 0.0f;
+        for(size_t i = 0; i < count; i++)
+        {
+            for(int column = 0; column < 4; column++)
+            {
+                float magnitude = std::max(1.0f, glm::length(reference[i][column]));
+                for(int row = 0; row < 4; row++)
+                {
+                    max_error = std::max(max_error, std::abs(batched[i][column][row] - reference[i][column][row]) / magnitude);
+                }
+            }
+        }
+
+        std::printf("%8zu transforms: glm %9.3f ms, kernel %9.3f ms, speedup %5.2fx, max error %g\n",
+                    count, reference_ms, batched_ms, reference_ms / batched_ms, max_error);
+    }
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include "Application.h"
 #include <GL/wglew.h>
 #include <exception>
+#include <algorithm>
 
 #include "managers/ResourcesManager.h"
 #include "managers/SceneManager.h"
@@ -70,6 +71,9 @@ namespace vis
         m_main_window_open         = true;
         m_refresh_rate             = 60.0f;
         m_refresh_interval         = 0.0f;
+        m_accumulator              = 0.0;
+        m_max_substeps             = 5;
+        m_interpolation_alpha      = 0.0f;
 
         m_window           = Window::create_window({1920, 1080, "Shark"});
         m_global_register  = std::make_unique<GlobalRegister>();
@@ -110,21 +114,27 @@ namespace vis
         }
     }
 
+    //Layers are updated in fixed steps of m_refresh_interval, whatever is left of the accumulated time is carried
+    //to the next call and exposed as interpolation alpha.
     void Application::on_update()
     {
-        float delta_time = m_timer.get_delta_time();
-        while(delta_time > m_refresh_interval) {
+        m_accumulator = std::min(m_accumulator + m_step_timer.lap(), double(m_refresh_interval) * m_max_substeps);
+
+        while(m_accumulator >= m_refresh_interval)
+        {
             POINT cursor_pos;
             if(GetCursorPos(&cursor_pos))
             {
                 m_input->set_mouse_pos(cursor_pos.x, cursor_pos.y);
             }
 
-            m_layer_stack.update_all_layers(delta_time);
+            m_layer_stack.update_all_layers(m_refresh_interval);
 
-            delta_time -= m_refresh_interval;
+            m_accumulator -= m_refresh_interval;
             m_timer.new_time_stamp();
         }
+
+        m_interpolation_alpha.store(static_cast<float>(m_accumulator / m_refresh_interval), std::memory_order_relaxed);
     }
 
     void Application::on_render()
@@ -175,6 +185,17 @@ namespace vis
         recalculate_refresh_interval();
     }
 
+    void Application::set_max_substeps(int a_max_substeps)
+    {
+        if(a_max_substeps < 1)
+        {
+            LOG_WARNING("Max substeps must be at least 1, got: {0}", a_max_substeps);
+            return;
+        }
+
+        m_max_substeps = a_max_substeps;
+    }
+
     Application *Application::create_instance()
     {
         if(m_instance != nullptr)
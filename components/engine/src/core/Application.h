@@ -6,6 +6,7 @@
 #define VISUAL_APPLICATION_H
 
 #include <memory>
+#include <atomic>
 #include <iostream>
 #include <functional>
 
@@ -41,6 +42,12 @@ namespace vis
         void recalculate_refresh_interval();
         void set_refresh_interval(int a_refresh_rate);
 
+        //Fixed steps run per on_update at most, time past them is dropped and the simulation falls behind instead.
+        void set_max_substeps(int a_max_substeps);
+
+        //Fraction of a fixed step accumulated past the last one, blends previous and current state for rendering.
+        inline float get_interpolation_alpha() const { return m_interpolation_alpha.load(std::memory_order_relaxed); }
+
         inline static Input* get_input_instance() { return m_input; }
         inline static Window* get_window_instance() { return m_window; }
         inline static Application* get_instance() { return m_instance; }
@@ -76,12 +83,16 @@ namespace vis
         static bool                  m_layers_attached;
 
         Timer                        m_timer;
+        Timer                        m_step_timer;
         LayerStack                   m_layer_stack;
 
         std::unique_ptr<Framebuffer> m_scene_framebuffer;
 
         float                        m_refresh_rate; //frames per second
         float                        m_refresh_interval;
+        double                       m_accumulator;
+        int                          m_max_substeps;
+        std::atomic<float>           m_interpolation_alpha;
         bool                         m_main_window_open;
 
         std::unique_ptr<GlobalRegister> m_global_register;
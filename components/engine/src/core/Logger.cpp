@@ -4,6 +4,10 @@
 
 #include "Logger.h"
 
+#include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include "ImGui/imgui.h"
+
 namespace vis
 {
     std::shared_ptr<spdlog::logger> Logger::m_logger;
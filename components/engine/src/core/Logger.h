@@ -6,9 +6,21 @@
 #define MAIN_LOGGER_H
 
 #include <memory>
-#include <spdlog/spdlog.h>
-#include <spdlog/sinks/stdout_color_sinks.h>
-#include "ImGui/imgui.h"
+#include <string>
+#include <vector>
+#include <utility>
+
+//Without LOGGER_ACTIVE the macros expand to nothing and users of this header need neither spdlog nor ImGui.
+#ifdef LOGGER_ACTIVE
+    #include <spdlog/spdlog.h>
+#endif
+
+struct ImVec4;
+
+namespace spdlog
+{
+    class logger;
+}
 
 #ifdef LOGGER_ACTIVE
     #define LOG_INFO(...)   vis::Logger::get_instance()->info(__VA_ARGS__); vis::SceneConsole::get_instance()->log_info(__VA_ARGS__)
@@ -2,6 +2,9 @@
 // Created by BlackFlage on 06.02.2022.
 //
 
+#include <atomic>
+#include <algorithm>
+
 #include "TPool.h"
 #include "Logger.h"
 
@@ -21,6 +24,8 @@ namespace vis
             return;
         }
 
+        m_threads_available = true;
+
         for(unsigned int i = 0; i < max_threads; i++)
         {
             m_threads.push_back(std::thread(&TPool::thread_default_function, this));
@@ -94,12 +99,87 @@ namespace vis
         return true;
     }
 
+    size_t TPool::get_thread_count() const
+    {
+        return m_threads.size();
+    }
+
+    void TPool::parallel_for(size_t a_count, size_t a_grain, const std::function<void(size_t, size_t, size_t)>& a_func)
+    {
+        struct ParallelState
+        {
+            std::function<void(size_t, size_t, size_t)> m_func;
+            std::atomic<size_t>                         m_next_range;
+            std::atomic<size_t>                         m_done_ranges;
+            size_t                                      m_ranges_count;
+            size_t                                      m_count;
+            size_t                                      m_grain;
+            std::mutex                                  m_mutex;
+            std::condition_variable                     m_done;
+        };
+
+        if(a_count == 0)
+        {
+            return;
+        }
+
+        a_grain = std::max<size_t>(a_grain, 1);
+        size_t ranges_count = (a_count + a_grain - 1) / a_grain;
+
+        if(ranges_count == 1 || !m_threads_available)
+        {
+            a_func(0, a_count, 0);
+            return;
+        }
+
+        auto state = std::make_shared<ParallelState>();
+        state->m_func         = a_func;
+        state->m_next_range   = 0;
+        state->m_done_ranges  = 0;
+        state->m_ranges_count = ranges_count;
+        state->m_count        = a_count;
+        state->m_grain        = a_grain;
+
+        //Late jobs find no ranges left and return without touching a_func, so waiting for ranges
+        //instead of jobs is enough and calling this from a pool thread can't dead lock.
+        auto work = [state](size_t a_slot) {
+            size_t range;
+            while((range = state->m_next_range.fetch_add(1)) < state->m_ranges_count)
+            {
+                size_t begin = range * state->m_grain;
+                size_t end = std::min(begin + state->m_grain, state->m_count);
+
+                state->m_func(begin, end, a_slot);
+
+                if(state->m_done_ranges.fetch_add(1) + 1 == state->m_ranges_count)
+                {
+                    std::lock_guard<std::mutex> lock(state->m_mutex);
+                    state->m_done.notify_all();
+                }
+            }
+        };
+
+        size_t jobs_count = std::min(m_threads.size(), ranges_count - 1);
+        for(size_t slot = 1; slot <= jobs_count; slot++)
+        {
+            add_job([work, slot]() { work(slot); });
+        }
+
+        work(0);
+
+        std::unique_lock<std::mutex> lock(state->m_mutex);
+        state->m_done.wait(lock, [&state]() { return state->m_done_ranges == state->m_ranges_count; });
+    }
+
     void TPool::shutdown()
     {
         if(!m_instance)
             return;
 
-        m_instance->m_terminate_pool = true;
+        {
+            std::unique_lock<std::mutex> lock(m_instance->m_queue_mutex);
+            m_instance->m_terminate_pool = true;
+        }
 
         m_instance->m_run_condition.notify_all();
 
@@ -10,6 +10,7 @@
 #include <mutex>
 #include <functional>
 #include <queue>
+#include <condition_variable>
 
 namespace vis
 {
@@ -22,6 +23,12 @@ namespace vis
         TPool& operator=(const TPool& other) = delete;
 
         bool add_job(std::function<void()> job);
+        size_t get_thread_count() const;
+
+        //Splits [0, a_count) into ranges of a_grain and calls a_func(begin, end, slot) for each of them on pool
+        //threads and the calling thread. Returns once every range is processed. Slot identifies the participant,
+        //it is always lower than get_thread_count() + 1, the calling thread uses slot 0.
+        void parallel_for(size_t a_count, size_t a_grain, const std::function<void(size_t, size_t, size_t)>& a_func);
 
         static void shutdown();
         static void initialize();
@@ -11,10 +11,50 @@
 using Component = std::uint8_t;
 using ComponentType = std::uint8_t;
 
-#define MAX_ENTITIES 2048
+//Entity handle, slot index in the upper bits and generation of the slot in the lower ones. Generation is bumped
+//every time a slot is recycled, so handles of destroyed entities stop matching. Ordering handles orders by index.
+using EntityID = std::uint32_t;
+
+#define ENTITY_GENERATION_BITS 10
+#define ENTITY_INDEX_BITS 22
+#define ENTITY_GENERATION_MASK ((1u << ENTITY_GENERATION_BITS) - 1)
+#define NULL_ENTITY UINT32_MAX
+
+//Generation reserved for placeholders handed out by command buffers, live entities never use it.
+#define PENDING_ENTITY_GENERATION ENTITY_GENERATION_MASK
+
+#define MAX_ENTITIES ((1u << ENTITY_INDEX_BITS) - 1)
+#define ENTITY_PAGE_SIZE 4096
 #define MAX_COMPONENTS 128
 #define MAX_RESOURCES 1000
 
 using Signature = std::bitset<MAX_COMPONENTS>;
 
+struct SignatureChange
+{
+    EntityID  m_entity;
+    Signature m_old_signature;
+    Signature m_new_signature;
+};
+
+inline std::uint32_t get_entity_index(EntityID a_id)
+{
+    return a_id >> ENTITY_GENERATION_BITS;
+}
+
+inline std::uint32_t get_entity_generation(EntityID a_id)
+{
+    return a_id & ENTITY_GENERATION_MASK;
+}
+
+inline EntityID make_entity_id(std::uint32_t a_index, std::uint32_t a_generation)
+{
+    return (a_index << ENTITY_GENERATION_BITS) | (a_generation & ENTITY_GENERATION_MASK);
+}
+
+inline bool is_pending_entity(EntityID a_id)
+{
+    return a_id != NULL_ENTITY && get_entity_generation(a_id) == PENDING_ENTITY_GENERATION;
+}
+
 #endif //MAIN_TYPES_H
@@ -0,0 +1,336 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "ArchetypeStorage.h"
+
+namespace vis
+{
+    ArchetypeStorage::ArchetypeStorage()
+    {
+        m_archetypes = std::vector<Archetype>();
+        m_signature_to_archetype = std::unordered_map<Signature, std::uint32_t>();
+        m_component_infos = std::array<ComponentInfo, MAX_COMPONENTS>();
+        m_locations = std::vector<EntityLocation>();
+    }
+
+    ArchetypeStorage::~ArchetypeStorage()
+    {
+        for(auto& archetype : m_archetypes)
+        {
+            for(size_t row = 0; row < archetype.m_size; row++)
+            {
+                for(size_t column = 0; column < archetype.m_types.size(); column++)
+                {
+                    m_component_infos[archetype.m_types[column]].m_destroy(get_cell(archetype, row, column));
+                }
+            }
+        }
+    }
+
+    void ArchetypeStorage::add_component_erased(EntityID a_id, ComponentType a_type, void* a_component)
+    {
+        void* cell = insert_component(a_id, a_type);
+
+        if(cell)
+        {
+            m_component_infos[a_type].m_move_construct(cell, a_component);
+        }
+    }
+
+    void ArchetypeStorage::copy_component(EntityID a_from, EntityID a_to, ComponentType a_type)
+    {
+        EntityLocation source = get_location(a_from);
+
+        if(source.m_archetype == INVALID_ARCHETYPE || !m_archetypes[source.m_archetype].m_signature[a_type])
+        {
+            LOG_WARNING("Trying to copy non existing data of entity: {0}", a_from);
+            return;
+        }
+
+        void* cell = insert_component(a_to, a_type);
+
+        if(!cell)
+        {
+            return;
+        }
+
+        //Moving a_to may have swapped a_from into another row, look the source up again.
+        source = get_location(a_from);
+        Archetype& archetype = m_archetypes[source.m_archetype];
+        m_component_infos[a_type].m_copy_construct(cell, get_cell(archetype, source.m_row, archetype.m_column_of_type[a_type]));
+    }
+
+    void* ArchetypeStorage::insert_component(EntityID a_id, ComponentType a_type)
+    {
+        EntityLocation& location = get_location(a_id);
+        std::uint32_t target;
+        size_t row;
+
+        if(location.m_archetype == INVALID_ARCHETYPE)
+        {
+            Signature signature;
+            signature.set(a_type, true);
+
+            target = get_or_create_archetype(signature);
+            row = push_row(m_archetypes[target], a_id);
+        }
+        else
+        {
+            if(m_archetypes[location.m_archetype].m_signature[a_type])
+            {
+                LOG_WARNING("Trying to add data to entity: {0} more than once!", a_id);
+                return nullptr;
+            }
+
+            target = get_add_target(location.m_archetype, a_type);
+            row = move_entity(a_id, location.m_archetype, target);
+        }
+
+        get_location(a_id) = EntityLocation{ .m_archetype = target, .m_row = static_cast<std::uint32_t>(row) };
+
+        Archetype& archetype = m_archetypes[target];
+
+        return get_cell(archetype, row, archetype.m_column_of_type[a_type]);
+    }
+
+    void ArchetypeStorage::remove_component(EntityID a_id, ComponentType a_type)
+    {
+        EntityLocation& location = get_location(a_id);
+
+        if(location.m_archetype == INVALID_ARCHETYPE || !m_archetypes[location.m_archetype].m_signature[a_type])
+        {
+            LOG_WARNING("Trying to remove non existing data from entity: {0}", a_id);
+            return;
+        }
+
+        Archetype& source = m_archetypes[location.m_archetype];
+        m_component_infos[a_type].m_destroy(get_cell(source, location.m_row, source.m_column_of_type[a_type]));
+
+        if(source.m_signature.count() == 1)
+        {
+            erase_row(source, location.m_row);
+            location.m_archetype = INVALID_ARCHETYPE;
+            return;
+        }
+
+        std::uint32_t target = get_remove_target(location.m_archetype, a_type);
+        size_t row = move_entity(a_id, location.m_archetype, target);
+
+        get_location(a_id) = EntityLocation{ .m_archetype = target, .m_row = static_cast<std::uint32_t>(row) };
+    }
+
+    size_t ArchetypeStorage::get_component_count(ComponentType a_type) const
+    {
+        size_t count = 0;
+
+        for(const auto& archetype : m_archetypes)
+        {
+            if(archetype.m_signature[a_type])
+            {
+                count += archetype.m_size;
+            }
+        }
+
+        return count;
+    }
+
+    void ArchetypeStorage::on_entity_destroyed(EntityID a_id)
+    {
+        EntityLocation& location = get_location(a_id);
+
+        if(location.m_archetype == INVALID_ARCHETYPE)
+        {
+            return;
+        }
+
+        Archetype& archetype = m_archetypes[location.m_archetype];
+        for(size_t column = 0; column < archetype.m_types.size(); column++)
+        {
+            m_component_infos[archetype.m_types[column]].m_destroy(get_cell(archetype, location.m_row, column));
+        }
+
+        erase_row(archetype, location.m_row);
+        location.m_archetype = INVALID_ARCHETYPE;
+    }
+
+    std::uint32_t ArchetypeStorage::get_or_create_archetype(const Signature& a_signature)
+    {
+        auto it = m_signature_to_archetype.find(a_signature);
+        if(it != m_signature_to_archetype.end())
+        {
+            return it->second;
+        }
+
+        Archetype archetype;
+        archetype.m_signature = a_signature;
+        archetype.m_size = 0;
+        archetype.m_column_of_type.fill(INVALID_COLUMN);
+        archetype.m_add_edges.fill(INVALID_ARCHETYPE);
+        archetype.m_remove_edges.fill(INVALID_ARCHETYPE);
+
+        size_t row_size = sizeof(EntityID);
+        size_t padding = 0;
+        for(ComponentType type = 0; type < MAX_COMPONENTS; type++)
+        {
+            if(a_signature[type])
+            {
+                archetype.m_column_of_type[type] = static_cast<std::int16_t>(archetype.m_types.size());
+                archetype.m_types.push_back(type);
+                row_size += m_component_infos[type].m_size;
+                padding += m_component_infos[type].m_alignment;
+            }
+        }
+
+        //Rows bigger than a chunk get chunks spanning several blocks, holding at least one row.
+        archetype.m_chunk_blocks = (row_size + padding + ARCHETYPE_CHUNK_SIZE - 1) / ARCHETYPE_CHUNK_SIZE;
+        archetype.m_chunk_capacity = (archetype.m_chunk_blocks * ARCHETYPE_CHUNK_SIZE - padding) / row_size;
+
+        size_t offset = archetype.m_chunk_capacity * sizeof(EntityID);
+        for(ComponentType type : archetype.m_types)
+        {
+            const ComponentInfo& info = m_component_infos[type];
+
+            offset = (offset + info.m_alignment - 1) / info.m_alignment * info.m_alignment;
+            archetype.m_column_offsets.push_back(offset);
+            offset += archetype.m_chunk_capacity * info.m_size;
+        }
+
+        auto index = static_cast<std::uint32_t>(m_archetypes.size());
+        m_archetypes.push_back(std::move(archetype));
+        m_signature_to_archetype.insert({a_signature, index});
+
+        return index;
+    }
+
+    std::uint32_t ArchetypeStorage::get_add_target(std::uint32_t a_archetype, ComponentType a_type)
+    {
+        std::uint32_t target = m_archetypes[a_archetype].m_add_edges[a_type];
+
+        if(target == INVALID_ARCHETYPE)
+        {
+            Signature signature = m_archetypes[a_archetype].m_signature;
+            signature.set(a_type, true);
+
+            target = get_or_create_archetype(signature);
+            m_archetypes[a_archetype].m_add_edges[a_type] = target;
+            m_archetypes[target].m_remove_edges[a_type] = a_archetype;
+        }
+
+        return target;
+    }
+
+    std::uint32_t ArchetypeStorage::get_remove_target(std::uint32_t a_archetype, ComponentType a_type)
+    {
+        std::uint32_t target = m_archetypes[a_archetype].m_remove_edges[a_type];
+
+        if(target == INVALID_ARCHETYPE)
+        {
+            Signature signature = m_archetypes[a_archetype].m_signature;
+            signature.set(a_type, false);
+
+            target = get_or_create_archetype(signature);
+            m_archetypes[a_archetype].m_remove_edges[a_type] = target;
+            m_archetypes[target].m_add_edges[a_type] = a_archetype;
+        }
+
+        return target;
+    }
+
+    size_t ArchetypeStorage::push_row(Archetype& a_archetype, EntityID a_id)
+    {
+        size_t row = a_archetype.m_size;
+        size_t chunk = row / a_archetype.m_chunk_capacity;
+
+        if(chunk == a_archetype.m_chunks.size())
+        {
+            a_archetype.m_chunks.push_back(std::make_unique<ArchetypeChunk[]>(a_archetype.m_chunk_blocks));
+        }
+
+        a_archetype.get_entities(chunk)[row % a_archetype.m_chunk_capacity] = a_id;
+        a_archetype.m_size++;
+
+        return row;
+    }
+
+    //Cells of the erased row must be already destroyed, the last row is moved into the hole.
+    void ArchetypeStorage::erase_row(Archetype& a_archetype, size_t a_row)
+    {
+        size_t last = a_archetype.m_size - 1;
+        size_t capacity = a_archetype.m_chunk_capacity;
+
+        if(a_row != last)
+        {
+            for(size_t column = 0; column < a_archetype.m_types.size(); column++)
+            {
+                const ComponentInfo& info = m_component_infos[a_archetype.m_types[column]];
+                void* last_cell = get_cell(a_archetype, last, column);
+
+                info.m_move_construct(get_cell(a_archetype, a_row, column), last_cell);
+                info.m_destroy(last_cell);
+            }
+
+            EntityID moved_entity = a_archetype.get_entities(last / capacity)[last % capacity];
+            a_archetype.get_entities(a_row / capacity)[a_row % capacity] = moved_entity;
+            get_location(moved_entity).m_row = static_cast<std::uint32_t>(a_row);
+        }
+
+        a_archetype.m_size--;
+
+        if(a_archetype.m_size % capacity == 0 && a_archetype.m_size / capacity < a_archetype.m_chunks.size())
+        {
+            a_archetype.m_chunks.pop_back();
+        }
+    }
+
+    void* ArchetypeStorage::get_cell(Archetype& a_archetype, size_t a_row, std::int16_t a_column)
+    {
+        size_t chunk = a_row / a_archetype.m_chunk_capacity;
+        size_t index = a_row % a_archetype.m_chunk_capacity;
+        size_t size = m_component_infos[a_archetype.m_types[a_column]].m_size;
+
+        return a_archetype.get_column(chunk, a_column) + index * size;
+    }
+
+    size_t ArchetypeStorage::move_entity(EntityID a_id, std::uint32_t a_from, std::uint32_t a_to)
+    {
+        Archetype& source = m_archetypes[a_from];
+        Archetype& destination = m_archetypes[a_to];
+        size_t source_row = get_location(a_id).m_row;
+        size_t destination_row = push_row(destination, a_id);
+
+        for(size_t column = 0; column < source.m_types.size(); column++)
+        {
+            ComponentType type = source.m_types[column];
+            std::int16_t destination_column = destination.m_column_of_type[type];
+
+            if(destination_column == INVALID_COLUMN)
+            {
+                continue;
+            }
+
+            const ComponentInfo& info = m_component_infos[type];
+            void* source_cell = get_cell(source, source_row, column);
+
+            info.m_move_construct(get_cell(destination, destination_row, destination_column), source_cell);
+            info.m_destroy(source_cell);
+        }
+
+        //Every column of the source row is dead by now, erase_row only has to fill the hole.
+        erase_row(source, source_row);
+
+        return destination_row;
+    }
+
+    ArchetypeStorage::EntityLocation& ArchetypeStorage::get_location(EntityID a_id)
+    {
+        std::uint32_t index = get_entity_index(a_id);
+
+        if(index >= m_locations.size())
+        {
+            m_locations.resize(index + 1, EntityLocation{ .m_archetype = INVALID_ARCHETYPE, .m_row = 0 });
+        }
+
+        return m_locations[index];
+    }
+}
\ No newline at end of file
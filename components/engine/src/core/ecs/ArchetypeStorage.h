@@ -0,0 +1,308 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_ARCHETYPESTORAGE_H
+#define MAIN_ARCHETYPESTORAGE_H
+
+#include <array>
+#include <utility>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+#include "Types.h"
+#include "Logger.h"
+
+#define ARCHETYPE_CHUNK_SIZE 16384
+#define INVALID_ARCHETYPE UINT32_MAX
+#define INVALID_COLUMN -1
+
+namespace vis
+{
+    //Type erased description of a component, enough to move it between archetype chunks.
+    struct ComponentInfo
+    {
+        size_t m_size;
+        size_t m_alignment;
+        void (*m_move_construct)(void* a_destination, void* a_source);
+        void (*m_copy_construct)(void* a_destination, const void* a_source);
+        void (*m_destroy)(void* a_data);
+    };
+
+    struct alignas(64) ArchetypeChunk
+    {
+        std::byte m_bytes[ARCHETYPE_CHUNK_SIZE];
+    };
+
+    //All entities sharing one signature. Rows are spread over fixed size chunks, inside a chunk
+    //every component type has its own column (SoA), preceded by the column of entity ids.
+    //A chunk is one ArchetypeChunk, or as many contiguous ones as it takes to hold a single row.
+    struct Archetype
+    {
+        Signature                                   m_signature;
+        std::vector<ComponentType>                  m_types;
+        std::vector<size_t>                         m_column_offsets;
+        std::array<std::int16_t, MAX_COMPONENTS>    m_column_of_type;
+        std::array<std::uint32_t, MAX_COMPONENTS>   m_add_edges;
+        std::array<std::uint32_t, MAX_COMPONENTS>   m_remove_edges;
+        std::vector<std::unique_ptr<ArchetypeChunk[]>> m_chunks;
+        size_t                                      m_chunk_blocks;
+        size_t                                      m_chunk_capacity;
+        size_t                                      m_size;
+
+        inline EntityID* get_entities(size_t a_chunk)
+        {
+            return reinterpret_cast<EntityID*>(m_chunks[a_chunk].get());
+        }
+
+        inline std::byte* get_column(size_t a_chunk, std::int16_t a_column)
+        {
+            return reinterpret_cast<std::byte*>(m_chunks[a_chunk].get()) + m_column_offsets[a_column];
+        }
+
+        inline size_t get_chunk_size(size_t a_chunk) const
+        {
+            size_t first_row = a_chunk * m_chunk_capacity;
+
+            return std::min(m_chunk_capacity, m_size - first_row);
+        }
+    };
+
+    class ArchetypeStorage
+    {
+    public:
+        ArchetypeStorage();
+        ~ArchetypeStorage();
+
+        ArchetypeStorage(const ArchetypeStorage& a_other) = delete;
+        ArchetypeStorage& operator=(const ArchetypeStorage& a_other) = delete;
+
+        template<typename T>
+        void register_component(ComponentType a_type);
+
+        template<typename T>
+        void add_component(EntityID a_id, ComponentType a_type, T& a_component);
+
+        template<typename T>
+        T& get_component(EntityID a_id, ComponentType a_type);
+
+        //Type erased add used by command buffers, the component is move constructed out of a_component.
+        void add_component_erased(EntityID a_id, ComponentType a_type, void* a_component);
+
+        //Places entities without any component into the archetype of Ts, every column filled with copies of a_components.
+        template<typename... Ts>
+        void add_entities(const EntityID* a_ids, size_t a_count, const std::array<ComponentType, sizeof...(Ts)>& a_types, const Ts&... a_components);
+
+        //Adds a copy of the a_type component of a_from to a_to.
+        void copy_component(EntityID a_from, EntityID a_to, ComponentType a_type);
+
+        void remove_component(EntityID a_id, ComponentType a_type);
+        size_t get_component_count(ComponentType a_type) const;
+        void on_entity_destroyed(EntityID a_id);
+
+        //Streams through every chunk of every archetype containing all requested types.
+        template<typename... Ts, typename F>
+        void each(const std::array<ComponentType, sizeof...(Ts)>& a_types, F&& a_func);
+
+        //Calls a_func(entities, count, Ts*...) once per matching chunk with base pointers of the requested columns.
+        template<typename... Ts, typename F>
+        void each_chunk(const std::array<ComponentType, sizeof...(Ts)>& a_types, F&& a_func);
+
+        //Type erased each_chunk over a single type, a_func(entities, count, column) gets the base of the a_type column.
+        template<typename F>
+        void each_column(ComponentType a_type, F&& a_func);
+    private:
+        struct EntityLocation
+        {
+            std::uint32_t m_archetype;
+            std::uint32_t m_row;
+        };
+
+        //Moves the entity to the archetype with a_type added and returns the uninitialized cell for the new
+        //component, nullptr when the entity already has it.
+        void* insert_component(EntityID a_id, ComponentType a_type);
+
+        std::uint32_t get_or_create_archetype(const Signature& a_signature);
+        std::uint32_t get_add_target(std::uint32_t a_archetype, ComponentType a_type);
+        std::uint32_t get_remove_target(std::uint32_t a_archetype, ComponentType a_type);
+
+        size_t push_row(Archetype& a_archetype, EntityID a_id);
+        void   erase_row(Archetype& a_archetype, size_t a_row);
+        void*  get_cell(Archetype& a_archetype, size_t a_row, std::int16_t a_column);
+
+        //Fills a_count rows of every column in a_chunk, starting at a_begin, with copies of a_components.
+        template<typename... Ts, size_t... Is>
+        static void fill_columns(Archetype& a_archetype, size_t a_chunk, size_t a_begin, size_t a_count,
+                                 const std::array<ComponentType, sizeof...(Ts)>& a_types, std::index_sequence<Is...>, const Ts&... a_components);
+
+        template<typename... Ts, typename F, size_t... Is>
+        static void call_with_columns(Archetype& a_archetype, size_t a_chunk, const std::array<std::int16_t, sizeof...(Ts)>& a_columns,
+                                      const EntityID* a_entities, size_t a_count, F& a_func, std::index_sequence<Is...>);
+
+        //Moves all components shared by both archetypes and returns the new row, the row in the
+        //source archetype is erased. Columns present only in the destination stay uninitialized.
+        size_t move_entity(EntityID a_id, std::uint32_t a_from, std::uint32_t a_to);
+
+        //Locations are indexed by entity index and grow on first use.
+        EntityLocation& get_location(EntityID a_id);
+    private:
+        std::vector<Archetype>                        m_archetypes;
+        std::unordered_map<Signature, std::uint32_t>  m_signature_to_archetype;
+        std::array<ComponentInfo, MAX_COMPONENTS>     m_component_infos;
+        std::vector<EntityLocation>                   m_locations;
+    };
+
+    template<typename T>
+    void ArchetypeStorage::register_component(ComponentType a_type)
+    {
+        m_component_infos[a_type] = ComponentInfo{
+            .m_size = sizeof(T),
+            .m_alignment = alignof(T),
+            .m_move_construct = [](void* a_destination, void* a_source) { new (a_destination) T(std::move(*static_cast<T*>(a_source))); },
+            .m_copy_construct = [](void* a_destination, const void* a_source) { new (a_destination) T(*static_cast<const T*>(a_source)); },
+            .m_destroy = [](void* a_data) { static_cast<T*>(a_data)->~T(); }
+        };
+    }
+
+    template<typename T>
+    void ArchetypeStorage::add_component(EntityID a_id, ComponentType a_type, T& a_component)
+    {
+        void* cell = insert_component(a_id, a_type);
+
+        if(cell)
+        {
+            new (cell) T(a_component);
+        }
+    }
+
+    template<typename... Ts>
+    void ArchetypeStorage::add_entities(const EntityID* a_ids, size_t a_count, const std::array<ComponentType, sizeof...(Ts)>& a_types, const Ts&... a_components)
+    {
+        Signature signature;
+        for(ComponentType type : a_types)
+        {
+            signature.set(type, true);
+        }
+
+        std::uint32_t target = get_or_create_archetype(signature);
+        Archetype& archetype = m_archetypes[target];
+        size_t first_row = archetype.m_size;
+
+        for(size_t i = 0; i < a_count; i++)
+        {
+            size_t row = push_row(archetype, a_ids[i]);
+            get_location(a_ids[i]) = EntityLocation{ .m_archetype = target, .m_row = static_cast<std::uint32_t>(row) };
+        }
+
+        //Columns are filled one chunk segment at a time.
+        size_t capacity = archetype.m_chunk_capacity;
+        for(size_t row = first_row; row < archetype.m_size;)
+        {
+            size_t chunk = row / capacity;
+            size_t begin = row % capacity;
+            size_t count = std::min(capacity - begin, archetype.m_size - row);
+
+            fill_columns<Ts...>(archetype, chunk, begin, count, a_types, std::index_sequence_for<Ts...>(), a_components...);
+
+            row += count;
+        }
+    }
+
+    //Like the sparse backend, an entity without T gets a default constructed placeholder.
+    template<typename T>
+    T& ArchetypeStorage::get_component(EntityID a_id, ComponentType a_type)
+    {
+        const EntityLocation& location = get_location(a_id);
+
+        if(location.m_archetype == INVALID_ARCHETYPE || m_archetypes[location.m_archetype].m_column_of_type[a_type] == INVALID_COLUMN)
+        {
+            static std::remove_const_t<T> invalid_data;
+            invalid_data = std::remove_const_t<T>();
+            return invalid_data;
+        }
+
+        Archetype& archetype = m_archetypes[location.m_archetype];
+
+        return *static_cast<T*>(get_cell(archetype, location.m_row, archetype.m_column_of_type[a_type]));
+    }
+
+    template<typename... Ts, typename F>
+    void ArchetypeStorage::each(const std::array<ComponentType, sizeof...(Ts)>& a_types, F&& a_func)
+    {
+        each_chunk<Ts...>(a_types, [&a_func](const EntityID* a_entities, size_t a_count, Ts*... a_bases) {
+            for(size_t i = 0; i < a_count; i++)
+            {
+                a_func(a_entities[i], a_bases[i]...);
+            }
+        });
+    }
+
+    template<typename... Ts, typename F>
+    void ArchetypeStorage::each_chunk(const std::array<ComponentType, sizeof...(Ts)>& a_types, F&& a_func)
+    {
+        Signature required;
+        for(ComponentType type : a_types)
+        {
+            required.set(type, true);
+        }
+
+        for(auto& archetype : m_archetypes)
+        {
+            if(archetype.m_size == 0 || (archetype.m_signature & required) != required)
+            {
+                continue;
+            }
+
+            std::array<std::int16_t, sizeof...(Ts)> columns;
+            for(size_t i = 0; i < a_types.size(); i++)
+            {
+                columns[i] = archetype.m_column_of_type[a_types[i]];
+            }
+
+            for(size_t chunk = 0; chunk < archetype.m_chunks.size(); chunk++)
+            {
+                const EntityID* entities = archetype.get_entities(chunk);
+                size_t count = archetype.get_chunk_size(chunk);
+
+                call_with_columns<Ts...>(archetype, chunk, columns, entities, count, a_func, std::index_sequence_for<Ts...>());
+            }
+        }
+    }
+
+    template<typename... Ts, size_t... Is>
+    void ArchetypeStorage::fill_columns(Archetype& a_archetype, size_t a_chunk, size_t a_begin, size_t a_count,
+                                        const std::array<ComponentType, sizeof...(Ts)>& a_types, std::index_sequence<Is...>, const Ts&... a_components)
+    {
+        (std::uninitialized_fill_n(reinterpret_cast<Ts*>(a_archetype.get_column(a_chunk, a_archetype.m_column_of_type[a_types[Is]])) + a_begin, a_count, a_components), ...);
+    }
+
+    template<typename... Ts, typename F, size_t... Is>
+    void ArchetypeStorage::call_with_columns(Archetype& a_archetype, size_t a_chunk, const std::array<std::int16_t, sizeof...(Ts)>& a_columns,
+                                             const EntityID* a_entities, size_t a_count, F& a_func, std::index_sequence<Is...>)
+    {
+        a_func(a_entities, a_count, reinterpret_cast<Ts*>(a_archetype.get_column(a_chunk, a_columns[Is]))...);
+    }
+
+    template<typename F>
+    void ArchetypeStorage::each_column(ComponentType a_type, F&& a_func)
+    {
+        for(auto& archetype : m_archetypes)
+        {
+            if(archetype.m_size == 0 || !archetype.m_signature[a_type])
+            {
+                continue;
+            }
+
+            std::int16_t column = archetype.m_column_of_type[a_type];
+            for(size_t chunk = 0; chunk < archetype.m_chunks.size(); chunk++)
+            {
+                a_func(archetype.get_entities(chunk), archetype.get_chunk_size(chunk), archetype.get_column(chunk, column));
+            }
+        }
+    }
+}
+
+#endif //MAIN_ARCHETYPESTORAGE_H
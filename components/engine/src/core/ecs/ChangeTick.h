@@ -0,0 +1,59 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_CHANGETICK_H
+#define MAIN_CHANGETICK_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace vis
+{
+    //Monotonic counter ordering component writes. ComponentArray stamps every add and mutable access with the
+    //current tick, Changed<T> and Added<T> view filters compare those stamps against the tick a reader last ran at.
+    class ChangeTick
+    {
+    public:
+        //Tick of writes made by the calling thread, the run tick of the system being updated if there is one.
+        static std::uint32_t get()
+        {
+            return t_system_tick != 0 ? t_system_tick : m_world_tick.load(std::memory_order_relaxed);
+        }
+
+        static std::uint32_t get_world()
+        {
+            return m_world_tick.load(std::memory_order_relaxed);
+        }
+
+        static void advance(std::uint32_t a_count = 1)
+        {
+            m_world_tick.fetch_add(a_count, std::memory_order_relaxed);
+        }
+
+        //Overrides tick of the calling thread while in scope, used by SystemScheduler around on_update.
+        class Scope
+        {
+        public:
+            explicit Scope(std::uint32_t a_tick) : m_previous(t_system_tick) { t_system_tick = a_tick; }
+            ~Scope() { t_system_tick = m_previous; }
+
+            Scope(const Scope& a_other) = delete;
+            Scope& operator=(const Scope& a_other) = delete;
+        private:
+            std::uint32_t m_previous;
+        };
+    private:
+        static inline std::atomic<std::uint32_t> m_world_tick = 1;
+        static inline thread_local std::uint32_t t_system_tick = 0;
+    };
+
+    //View filters, see View::filter.
+    template<typename T>
+    struct Changed {};
+
+    template<typename T>
+    struct Added {};
+}
+
+#endif //MAIN_CHANGETICK_H
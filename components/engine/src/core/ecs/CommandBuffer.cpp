@@ -0,0 +1,165 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "CommandBuffer.h"
+#include "Logger.h"
+
+#include <utility>
+#include <cstdint>
+#include <algorithm>
+
+namespace vis
+{
+    std::atomic<std::uint64_t> CommandQueue::m_next_id = 1;
+
+    CommandBuffer::CommandBuffer(std::atomic<std::uint32_t>* a_next_pending)
+    {
+        m_commands = std::vector<Command>();
+        m_current_block = 0;
+        m_block_offset = 0;
+        m_next_pending = a_next_pending;
+    }
+
+    CommandBuffer::~CommandBuffer()
+    {
+        clear();
+    }
+
+    EntityID CommandBuffer::create_entity()
+    {
+        std::uint32_t index = m_next_pending->fetch_add(1);
+
+        if(index >= MAX_ENTITIES)
+        {
+            LOG_ERROR("Maximum pending entities count reached!");
+            return NULL_ENTITY;
+        }
+
+        return make_entity_id(index, PENDING_ENTITY_GENERATION);
+    }
+
+    void CommandBuffer::destroy_entity(EntityID a_id)
+    {
+        m_commands.push_back(Command{
+            .m_entity = a_id,
+            .m_component = 0,
+            .m_type = CommandType::DESTROY_ENTITY,
+            .m_payload = nullptr,
+            .m_destroy_payload = nullptr
+        });
+    }
+
+    const std::vector<Command>& CommandBuffer::get_commands() const
+    {
+        return m_commands;
+    }
+
+    void CommandBuffer::clear()
+    {
+        for(Command& command : m_commands)
+        {
+            if(command.m_destroy_payload)
+            {
+                command.m_destroy_payload(command.m_payload);
+            }
+        }
+
+        m_commands.clear();
+        m_current_block = 0;
+        m_block_offset = 0;
+    }
+
+    void* CommandBuffer::allocate_payload(size_t a_size, size_t a_alignment)
+    {
+        while(m_current_block < m_payload_blocks.size())
+        {
+            size_t offset = (m_block_offset + a_alignment - 1) / a_alignment * a_alignment;
+
+            if(offset + a_size <= m_payload_block_sizes[m_current_block])
+            {
+                m_block_offset = offset + a_size;
+                return m_payload_blocks[m_current_block].get() + offset;
+            }
+
+            m_current_block++;
+            m_block_offset = 0;
+        }
+
+        //new[] of std::byte is aligned for any fundamental type, over aligned components get extra room.
+        size_t block_size = std::max<size_t>(COMMAND_PAYLOAD_BLOCK_SIZE, a_size + a_alignment);
+        m_payload_blocks.push_back(std::make_unique<std::byte[]>(block_size));
+        m_payload_block_sizes.push_back(block_size);
+        m_current_block = m_payload_blocks.size() - 1;
+
+        auto base = reinterpret_cast<std::uintptr_t>(m_payload_blocks[m_current_block].get());
+        size_t offset = (a_alignment - base % a_alignment) % a_alignment;
+        m_block_offset = offset + a_size;
+
+        return m_payload_blocks[m_current_block].get() + offset;
+    }
+
+    CommandQueue::CommandQueue()
+    {
+        m_buffers = std::vector<std::unique_ptr<CommandBuffer>>();
+        m_next_pending = 0;
+        m_id = m_next_id.fetch_add(1);
+    }
+
+    CommandBuffer& CommandQueue::get_buffer()
+    {
+        //Queue ids are never reused, so entries of destroyed queues simply stop matching.
+        thread_local std::vector<std::pair<std::uint64_t, CommandBuffer*>> t_buffers;
+
+        for(const auto& [id, buffer] : t_buffers)
+        {
+            if(id == m_id)
+            {
+                return *buffer;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_buffers_mutex);
+        m_buffers.push_back(std::make_unique<CommandBuffer>(&m_next_pending));
+        t_buffers.emplace_back(m_id, m_buffers.back().get());
+
+        return *m_buffers.back();
+    }
+
+    std::uint32_t CommandQueue::get_pending_count() const
+    {
+        return std::min<std::uint32_t>(m_next_pending.load(), MAX_ENTITIES);
+    }
+
+    std::vector<Command> CommandQueue::collect_commands() const
+    {
+        std::lock_guard<std::mutex> lock(m_buffers_mutex);
+        std::vector<Command> commands;
+
+        size_t count = 0;
+        for(const auto& buffer : m_buffers)
+        {
+            count += buffer->get_commands().size();
+        }
+
+        commands.reserve(count);
+        for(const auto& buffer : m_buffers)
+        {
+            commands.insert(commands.end(), buffer->get_commands().begin(), buffer->get_commands().end());
+        }
+
+        return commands;
+    }
+
+    void CommandQueue::reset()
+    {
+        std::lock_guard<std::mutex> lock(m_buffers_mutex);
+
+        for(auto& buffer : m_buffers)
+        {
+            buffer->clear();
+        }
+
+        m_next_pending = 0;
+    }
+}
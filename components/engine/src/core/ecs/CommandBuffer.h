@@ -0,0 +1,132 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_COMMANDBUFFER_H
+#define MAIN_COMMANDBUFFER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <new>
+
+#include "Types.h"
+#include "TypeId.h"
+#include "Logger.h"
+
+#define COMMAND_PAYLOAD_BLOCK_SIZE 65536
+
+namespace vis
+{
+    enum class CommandType : std::uint8_t
+    {
+        DESTROY_ENTITY,
+        ADD_COMPONENT,
+        REMOVE_COMPONENT
+    };
+
+    struct Command
+    {
+        EntityID      m_entity;
+        ComponentType m_component;
+        CommandType   m_type;
+        void*         m_payload;
+        void        (*m_destroy_payload)(void* a_payload);
+    };
+
+    //Structural changes recorded by a single thread. Nothing is applied until MainManager::flush_commands,
+    //so systems can record while they (or other systems) iterate component arrays.
+    class CommandBuffer
+    {
+    public:
+        explicit CommandBuffer(std::atomic<std::uint32_t>* a_next_pending);
+        ~CommandBuffer();
+
+        CommandBuffer(const CommandBuffer& a_other) = delete;
+        CommandBuffer& operator=(const CommandBuffer& a_other) = delete;
+
+        //Returns placeholder handle usable with the other calls of any buffer until the next flush.
+        EntityID create_entity();
+        void destroy_entity(EntityID a_id);
+
+        template<typename T>
+        void add_component(EntityID a_id, T a_component);
+
+        template<typename T>
+        void remove_component(EntityID a_id);
+
+        const std::vector<Command>& get_commands() const;
+
+        //Destroys payloads and forgets recorded commands, payload memory is kept for the next frame.
+        void clear();
+    private:
+        void* allocate_payload(size_t a_size, size_t a_alignment);
+    private:
+        std::vector<Command>                      m_commands;
+        std::vector<std::unique_ptr<std::byte[]>> m_payload_blocks;
+        std::vector<size_t>                       m_payload_block_sizes;
+        size_t                                    m_current_block;
+        size_t                                    m_block_offset;
+        std::atomic<std::uint32_t>*               m_next_pending;
+    };
+
+    //Owns one CommandBuffer per recording thread and the counter of pending entities shared by them.
+    class CommandQueue
+    {
+    public:
+        CommandQueue();
+
+        //Buffer of the calling thread, created on its first call.
+        CommandBuffer& get_buffer();
+
+        //Number of placeholders handed out since the last reset, placeholder index i maps to the i-th created entity.
+        std::uint32_t get_pending_count() const;
+
+        //Commands of every buffer, in order of recording within each buffer.
+        std::vector<Command> collect_commands() const;
+        void reset();
+    private:
+        std::vector<std::unique_ptr<CommandBuffer>> m_buffers;
+        mutable std::mutex                          m_buffers_mutex;
+        std::atomic<std::uint32_t>                  m_next_pending;
+        std::uint64_t                               m_id;
+
+        static std::atomic<std::uint64_t> m_next_id;
+    };
+
+    template<typename T>
+    void CommandBuffer::add_component(EntityID a_id, T a_component)
+    {
+        if(get_component_id<T>() >= MAX_COMPONENTS)
+        {
+            LOG_ERROR("Can't register component: {0}, MAX_COMPONENTS reached!", typeid(T).name());
+            return;
+        }
+
+        void* payload = new (allocate_payload(sizeof(T), alignof(T))) T(std::move(a_component));
+
+        m_commands.push_back(Command{
+            .m_entity = a_id,
+            .m_component = static_cast<ComponentType>(get_component_id<T>()),
+            .m_type = CommandType::ADD_COMPONENT,
+            .m_payload = payload,
+            .m_destroy_payload = [](void* a_payload) { static_cast<T*>(a_payload)->~T(); }
+        });
+    }
+
+    template<typename T>
+    void CommandBuffer::remove_component(EntityID a_id)
+    {
+        m_commands.push_back(Command{
+            .m_entity = a_id,
+            .m_component = static_cast<ComponentType>(get_component_id<T>()),
+            .m_type = CommandType::REMOVE_COMPONENT,
+            .m_payload = nullptr,
+            .m_destroy_payload = nullptr
+        });
+    }
+}
+
+#endif //MAIN_COMMANDBUFFER_H
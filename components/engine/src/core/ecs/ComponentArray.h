@@ -5,103 +5,534 @@
 #ifndef MAIN_COMPONENTARRAY_H
 #define MAIN_COMPONENTARRAY_H
 
-#include "unordered_map"
-#include "optional"
+#include <array>
+#include <vector>
+#include <memory>
+#include <numeric>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
 
 #include "Types.h"
 #include "Logger.h"
+#include "ChangeTick.h"
+
+#define SPARSE_PAGE_SIZE 1024
+#define INVALID_DENSE_INDEX UINT32_MAX
+#define MIN_DENSE_CAPACITY 64
 
 namespace vis
 {
+    //Storage parameters of a component type, specialize to change them. Sparse pages map a run of
+    //m_page_size entity indices, smaller pages suit components owned by few, scattered entities.
+    template<typename T>
+    struct ComponentTraits
+    {
+        static constexpr std::uint32_t m_page_size = SPARSE_PAGE_SIZE;
+    };
+
     class IComponentArray
     {
     public:
         virtual ~IComponentArray() = default;
-        virtual void on_entity_destroyed(std::uint16_t a_id) = 0;
+        virtual void on_entity_destroyed(EntityID a_id) = 0;
+
+        //Type erased add used by command buffers, a_data points to a component of the array type.
+        virtual void add_data_erased(EntityID a_id, void* a_data) = 0;
+
+        //Moves a_count packed components out of a_data, one to every entity of a_ids, which must be sorted and own none yet.
+        virtual void add_data_bulk_erased(const EntityID* a_ids, size_t a_count, void* a_data) = 0;
+        virtual void remove_data(EntityID a_id) = 0;
+        virtual void sort() = 0;
+
+        //Adds a copy of the component of a_from to a_to.
+        virtual void copy_data(EntityID a_from, EntityID a_to) = 0;
+
+        //Snapshot sharing all storage with this array, whichever of the two is written first copies the
+        //touched part. restore makes this array share the storage of a_snapshot again, nullptr empties it.
+        virtual std::unique_ptr<IComponentArray> clone() const = 0;
+        virtual void restore(const IComponentArray* a_snapshot) = 0;
+
+        //Type erased read access to the dense arrays, get_data_erased points to size() packed components.
+        virtual size_t size() const = 0;
+        virtual const EntityID* entities() const = 0;
+        virtual const void* get_data_erased() const = 0;
     };
 
+    //Sparse set storage. Sparse pages map entity index to dense index, dense arrays keep components packed
+    //together with the handle of the owning entity, so lookups are two loads and iteration is linear.
+    //Comparing the stored handle also rejects stale handles whose slot was recycled.
+    //Every dense slot carries the ChangeTick of its add and of its last mutable access.
+    //Dense arrays are kept sorted by entity id lazily, views walk several of them side by side.
+    //Sparse pages are allocated on first use and freed once no entity of their range owns T,
+    //dense arrays give back memory once they shrink to a quarter of their capacity.
+    //Sparse pages and dense arrays are shared with snapshots and copied on write, sparse ones page by page.
+    //Dense arrays are copied as a whole since views rely on them being contiguous.
     template<typename T>
     class ComponentArray : public IComponentArray
     {
+        static constexpr std::uint32_t m_page_size = ComponentTraits<T>::m_page_size;
+        static_assert(m_page_size > 0 && (m_page_size & (m_page_size - 1)) == 0, "Component page size must be a power of two");
     public:
         ComponentArray();
 
-        void add_data(std::uint16_t a_id, T& a_data);
-        void remove_data(std::uint16_t a_id);
+        void add_data(EntityID a_id, T& a_data);
+        void add_data_erased(EntityID a_id, void* a_data) override;
+
+        //Appends a copy of a_data for every entity of a_ids, which must be sorted and own no T yet.
+        void add_data_bulk(const EntityID* a_ids, size_t a_count, const T& a_data);
+        void add_data_bulk_erased(const EntityID* a_ids, size_t a_count, void* a_data) override;
+        void remove_data(EntityID a_id) override;
+
+        //Marks the component as changed, use get_data_const for reads.
+        T& get_data(EntityID a_id);
+        const T& get_data_const(EntityID a_id) const;
+        bool has_data(EntityID a_id) const;
+        void on_entity_destroyed(EntityID a_id) override;
 
-        T& get_data(std::uint16_t a_id);
-        void on_entity_destroyed(std::uint16_t a_id) override;
+        void copy_data(EntityID a_from, EntityID a_to) override;
+        std::unique_ptr<IComponentArray> clone() const override;
+        void restore(const IComponentArray* a_snapshot) override;
+
+        size_t size() const override;
+        T* data();
+        const T* data() const;
+        const void* get_data_erased() const override;
+        const EntityID* entities() const override;
+        const std::uint32_t* added_ticks() const;
+        std::uint32_t* changed_ticks();
+        const std::uint32_t* changed_ticks() const;
+
+        //Restores entity order of dense arrays after out of order adds or swap removals.
+        void sort() override;
+
+        size_t get_page_count() const;
+    private:
+        using SparsePage = std::array<std::uint32_t, m_page_size>;
+
+        struct DenseStorage
+        {
+            std::vector<T>             m_components;
+            std::vector<EntityID>      m_entities;
+            std::vector<std::uint32_t> m_added_ticks;
+            std::vector<std::uint32_t> m_changed_ticks;
+        };
+
+        //Dense storage for writing, copied first when a snapshot still shares it.
+        DenseStorage& get_dense();
+        std::uint32_t get_dense_index(EntityID a_id) const;
+        void set_dense_index(EntityID a_id, std::uint32_t a_index);
+        void release_unused_capacity();
+
+        //Bookkeeping of a bulk add whose components were already appended to the dense array.
+        void append_bulk(DenseStorage& a_dense, const EntityID* a_ids, size_t a_count);
     private:
-        std::array<T, MAX_ENTITIES> m_component_array;
-        std::unordered_map<std::uint16_t, size_t> m_entity_to_index;
-        std::unordered_map<size_t, std::uint16_t> m_index_to_entity;
+        std::shared_ptr<DenseStorage> m_dense;
+        std::vector<std::shared_ptr<SparsePage>> m_sparse_pages;
+        std::vector<std::uint32_t> m_sparse_page_counts;
+        size_t m_page_count;
+        T m_invalid_data;
 
         size_t m_current_size;
+        bool m_sorted;
     };
 
     template<typename T>
     ComponentArray<T>::ComponentArray()
     {
+        m_dense = std::make_shared<DenseStorage>();
         m_current_size = 0;
+        m_page_count = 0;
+        m_invalid_data = T();
+        m_sorted = true;
     }
 
     template<typename T>
-    void ComponentArray<T>::add_data(std::uint16_t a_id, T& a_data)
+    void ComponentArray<T>::add_data(EntityID a_id, T& a_data)
     {
-        if(m_entity_to_index.find(a_id) != m_entity_to_index.end())
+        if(has_data(a_id))
         {
             LOG_WARNING("Trying to add data to entity: {0} more than once!", a_id);
             return;
         }
 
+        DenseStorage& dense = get_dense();
         size_t data_index = m_current_size;
-        m_component_array[data_index] = a_data;
-        m_entity_to_index[a_id] = data_index;
-        m_index_to_entity[data_index] = a_id;
+        if(data_index > 0 && dense.m_entities[data_index - 1] > a_id)
+        {
+            m_sorted = false;
+        }
+
+        std::uint32_t tick = ChangeTick::get();
+
+        dense.m_components.push_back(a_data);
+        dense.m_entities.push_back(a_id);
+        dense.m_added_ticks.push_back(tick);
+        dense.m_changed_ticks.push_back(tick);
+        set_dense_index(a_id, data_index);
         m_current_size++;
     }
 
     template<typename T>
-    void ComponentArray<T>::remove_data(std::uint16_t a_id)
+    void ComponentArray<T>::add_data_erased(EntityID a_id, void* a_data)
     {
-        if(m_entity_to_index.find(a_id) == m_entity_to_index.end())
+        add_data(a_id, *static_cast<T*>(a_data));
+    }
+
+    template<typename T>
+    void ComponentArray<T>::add_data_bulk(const EntityID* a_ids, size_t a_count, const T& a_data)
+    {
+        if(a_count == 0)
+        {
+            return;
+        }
+
+        DenseStorage& dense = get_dense();
+        dense.m_components.insert(dense.m_components.end(), a_count, a_data);
+        append_bulk(dense, a_ids, a_count);
+    }
+
+    template<typename T>
+    void ComponentArray<T>::add_data_bulk_erased(const EntityID* a_ids, size_t a_count, void* a_data)
+    {
+        if(a_count == 0)
+        {
+            return;
+        }
+
+        T* components = static_cast<T*>(a_data);
+        DenseStorage& dense = get_dense();
+        dense.m_components.insert(dense.m_components.end(), std::make_move_iterator(components), std::make_move_iterator(components + a_count));
+        append_bulk(dense, a_ids, a_count);
+    }
+
+    template<typename T>
+    void ComponentArray<T>::append_bulk(DenseStorage& a_dense, const EntityID* a_ids, size_t a_count)
+    {
+        if(m_current_size > 0 && a_dense.m_entities[m_current_size - 1] > a_ids[0])
+        {
+            m_sorted = false;
+        }
+
+        std::uint32_t tick = ChangeTick::get();
+
+        a_dense.m_entities.insert(a_dense.m_entities.end(), a_ids, a_ids + a_count);
+        a_dense.m_added_ticks.insert(a_dense.m_added_ticks.end(), a_count, tick);
+        a_dense.m_changed_ticks.insert(a_dense.m_changed_ticks.end(), a_count, tick);
+
+        for(size_t i = 0; i < a_count; i++)
+        {
+            set_dense_index(a_ids[i], static_cast<std::uint32_t>(m_current_size + i));
+        }
+
+        m_current_size += a_count;
+    }
+
+    template<typename T>
+    void ComponentArray<T>::remove_data(EntityID a_id)
+    {
+        if(!has_data(a_id))
         {
             LOG_WARNING("Trying to remove non existing data from entity: {0}", a_id);
             return;
         }
 
-        size_t index_of_removed_entity = m_entity_to_index[a_id];
+        DenseStorage& dense = get_dense();
+        std::uint32_t index_of_removed_entity = get_dense_index(a_id);
+        size_t index_of_last = m_current_size - 1;
+        EntityID last_entity = dense.m_entities[index_of_last];
+
+        dense.m_components[index_of_removed_entity] = std::move(dense.m_components[index_of_last]);
+        dense.m_entities[index_of_removed_entity] = last_entity;
+        dense.m_added_ticks[index_of_removed_entity] = dense.m_added_ticks[index_of_last];
+        dense.m_changed_ticks[index_of_removed_entity] = dense.m_changed_ticks[index_of_last];
+        set_dense_index(last_entity, index_of_removed_entity);
+        set_dense_index(a_id, INVALID_DENSE_INDEX);
 
-        m_component_array[index_of_removed_entity] = m_component_array[m_current_size - 1];
-        m_entity_to_index[m_current_size - 1] = index_of_removed_entity;
-        m_index_to_entity[index_of_removed_entity] = m_current_size - 1;
+        dense.m_components.pop_back();
+        dense.m_entities.pop_back();
+        dense.m_added_ticks.pop_back();
+        dense.m_changed_ticks.pop_back();
 
-        m_entity_to_index.erase(a_id);
-        m_index_to_entity.erase(m_current_size - 1);
+        if(index_of_removed_entity != index_of_last)
+        {
+            m_sorted = false;
+        }
 
         m_current_size--;
+        release_unused_capacity();
+    }
+
+    template<typename T>
+    T& ComponentArray<T>::get_data(EntityID a_id)
+    {
+        if(!has_data(a_id))
+        {
+            m_invalid_data = T();
+            return m_invalid_data;
+        }
+
+        DenseStorage& dense = get_dense();
+        std::uint32_t index = get_dense_index(a_id);
+        dense.m_changed_ticks[index] = ChangeTick::get();
+
+        return dense.m_components[index];
     }
 
     template<typename T>
-    T& ComponentArray<T>::get_data(std::uint16_t a_id)
+    const T& ComponentArray<T>::get_data_const(EntityID a_id) const
     {
-        if(m_entity_to_index.find(a_id) == m_entity_to_index.end())
+        if(!has_data(a_id))
         {
-            T t;
-            return t;
+            return m_invalid_data;
         }
 
-        return m_component_array[m_entity_to_index[a_id]];
+        return m_dense->m_components[get_dense_index(a_id)];
+    }
+
+    template<typename T>
+    bool ComponentArray<T>::has_data(EntityID a_id) const
+    {
+        std::uint32_t index = get_dense_index(a_id);
+
+        return index < m_current_size && m_dense->m_entities[index] == a_id;
     }
 
     template<typename T>
-    void ComponentArray<T>::on_entity_destroyed(std::uint16_t a_id)
+    void ComponentArray<T>::on_entity_destroyed(EntityID a_id)
     {
-        if(m_entity_to_index.find(a_id) != m_entity_to_index.end())
+        if(has_data(a_id))
         {
             remove_data(a_id);
         }
     }
+
+    template<typename T>
+    void ComponentArray<T>::copy_data(EntityID a_from, EntityID a_to)
+    {
+        if(!has_data(a_from))
+        {
+            LOG_WARNING("Trying to copy non existing data of entity: {0}", a_from);
+            return;
+        }
+
+        T copy = get_data_const(a_from);
+        add_data(a_to, copy);
+    }
+
+    template<typename T>
+    std::unique_ptr<IComponentArray> ComponentArray<T>::clone() const
+    {
+        return std::make_unique<ComponentArray<T>>(*this);
+    }
+
+    template<typename T>
+    void ComponentArray<T>::restore(const IComponentArray* a_snapshot)
+    {
+        *this = a_snapshot ? *static_cast<const ComponentArray<T>*>(a_snapshot) : ComponentArray<T>();
+    }
+
+    template<typename T>
+    size_t ComponentArray<T>::size() const
+    {
+        return m_current_size;
+    }
+
+    template<typename T>
+    T* ComponentArray<T>::data()
+    {
+        return get_dense().m_components.data();
+    }
+
+    template<typename T>
+    const T* ComponentArray<T>::data() const
+    {
+        return m_dense->m_components.data();
+    }
+
+    template<typename T>
+    const void* ComponentArray<T>::get_data_erased() const
+    {
+        return m_dense->m_components.data();
+    }
+
+    template<typename T>
+    const EntityID* ComponentArray<T>::entities() const
+    {
+        return m_dense->m_entities.data();
+    }
+
+    template<typename T>
+    const std::uint32_t* ComponentArray<T>::added_ticks() const
+    {
+        return m_dense->m_added_ticks.data();
+    }
+
+    template<typename T>
+    std::uint32_t* ComponentArray<T>::changed_ticks()
+    {
+        return get_dense().m_changed_ticks.data();
+    }
+
+    template<typename T>
+    const std::uint32_t* ComponentArray<T>::changed_ticks() const
+    {
+        return m_dense->m_changed_ticks.data();
+    }
+
+    template<typename T>
+    void ComponentArray<T>::sort()
+    {
+        if(m_sorted)
+        {
+            return;
+        }
+
+        DenseStorage& dense = get_dense();
+        std::vector<std::uint32_t> order(m_current_size);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&dense](std::uint32_t a_lhs, std::uint32_t a_rhs) {
+            return dense.m_entities[a_lhs] < dense.m_entities[a_rhs];
+        });
+
+        std::vector<T> components;
+        std::vector<EntityID> entities;
+        std::vector<std::uint32_t> added_ticks;
+        std::vector<std::uint32_t> changed_ticks;
+        components.reserve(m_current_size);
+        entities.reserve(m_current_size);
+        added_ticks.reserve(m_current_size);
+        changed_ticks.reserve(m_current_size);
+
+        for(std::uint32_t index : order)
+        {
+            components.push_back(std::move(dense.m_components[index]));
+            entities.push_back(dense.m_entities[index]);
+            added_ticks.push_back(dense.m_added_ticks[index]);
+            changed_ticks.push_back(dense.m_changed_ticks[index]);
+        }
+
+        for(size_t i = 0; i < m_current_size; i++)
+        {
+            dense.m_components[i] = std::move(components[i]);
+            set_dense_index(entities[i], i);
+        }
+
+        dense.m_entities = std::move(entities);
+        dense.m_added_ticks = std::move(added_ticks);
+        dense.m_changed_ticks = std::move(changed_ticks);
+
+        m_sorted = true;
+    }
+
+    template<typename T>
+    size_t ComponentArray<T>::get_page_count() const
+    {
+        return m_page_count;
+    }
+
+    template<typename T>
+    typename ComponentArray<T>::DenseStorage& ComponentArray<T>::get_dense()
+    {
+        if(m_dense.use_count() > 1)
+        {
+            m_dense = std::make_shared<DenseStorage>(*m_dense);
+        }
+
+        return *m_dense;
+    }
+
+    template<typename T>
+    std::uint32_t ComponentArray<T>::get_dense_index(EntityID a_id) const
+    {
+        std::uint32_t index = get_entity_index(a_id);
+        size_t page = index / m_page_size;
+
+        if(page >= m_sparse_pages.size() || !m_sparse_pages[page])
+        {
+            return INVALID_DENSE_INDEX;
+        }
+
+        return (*m_sparse_pages[page])[index % m_page_size];
+    }
+
+    template<typename T>
+    void ComponentArray<T>::set_dense_index(EntityID a_id, std::uint32_t a_index)
+    {
+        std::uint32_t index = get_entity_index(a_id);
+        size_t page = index / m_page_size;
+
+        if(page >= m_sparse_pages.size())
+        {
+            if(a_index == INVALID_DENSE_INDEX)
+            {
+                return;
+            }
+
+            m_sparse_pages.resize(page + 1);
+            m_sparse_page_counts.resize(page + 1, 0);
+        }
+
+        if(!m_sparse_pages[page])
+        {
+            if(a_index == INVALID_DENSE_INDEX)
+            {
+                return;
+            }
+
+            m_sparse_pages[page] = std::make_shared<SparsePage>();
+            m_sparse_pages[page]->fill(INVALID_DENSE_INDEX);
+            m_page_count++;
+        }
+        else if(m_sparse_pages[page].use_count() > 1)
+        {
+            m_sparse_pages[page] = std::make_shared<SparsePage>(*m_sparse_pages[page]);
+        }
+
+        std::uint32_t& slot = (*m_sparse_pages[page])[index % m_page_size];
+
+        if(slot == INVALID_DENSE_INDEX && a_index != INVALID_DENSE_INDEX)
+        {
+            m_sparse_page_counts[page]++;
+        }
+        else if(slot != INVALID_DENSE_INDEX && a_index == INVALID_DENSE_INDEX)
+        {
+            m_sparse_page_counts[page]--;
+        }
+
+        slot = a_index;
+
+        if(m_sparse_page_counts[page] == 0)
+        {
+            m_sparse_pages[page].reset();
+            m_page_count--;
+        }
+    }
+
+    //Halving the capacity only below a quarter leaves room for churn around a stable size without reallocating.
+    template<typename T>
+    void ComponentArray<T>::release_unused_capacity()
+    {
+        DenseStorage& dense = get_dense();
+        size_t capacity = dense.m_components.capacity();
+
+        if(capacity <= MIN_DENSE_CAPACITY || m_current_size > capacity / 4)
+        {
+            return;
+        }
+
+        auto halve = [](auto& a_vector) {
+            std::remove_reference_t<decltype(a_vector)> halved;
+            halved.reserve(a_vector.capacity() / 2);
+            halved.insert(halved.end(), std::make_move_iterator(a_vector.begin()), std::make_move_iterator(a_vector.end()));
+            a_vector.swap(halved);
+        };
+
+        halve(dense.m_components);
+        halve(dense.m_entities);
+        halve(dense.m_added_ticks);
+        halve(dense.m_changed_ticks);
+    }
 }
 
-#endif //MAIN_COMPONENTARRAY_H
\ No newline at end of file
+#endif //MAIN_COMPONENTARRAY_H
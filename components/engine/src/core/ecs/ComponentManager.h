@@ -5,100 +5,371 @@
 #ifndef MAIN_COMPONENTMANAGER_H
 #define MAIN_COMPONENTMANAGER_H
 
-#include <unordered_map>
+#include <vector>
 #include <memory>
+#include <algorithm>
+#include <functional>
 
 #include "Types.h"
 #include "ComponentArray.h"
+#include "TagArray.h"
+#include "TypeId.h"
 #include "Entity.h"
 
+#define INVALID_OBSERVER UINT32_MAX
+
 namespace vis
 {
+    using ObserverId = std::uint32_t;
+
+    //Net changes of one component type since the previous dispatch, both lists sorted. Removed entities no longer
+    //own the component and may be destroyed, entities whose component was removed and added again are in both.
+    struct ComponentEvents
+    {
+        ComponentType         m_type;
+        std::vector<EntityID> m_added = {};
+        std::vector<EntityID> m_removed = {};
+    };
+
+    using ComponentObserver = std::function<void(const ComponentEvents& a_events)>;
+
     class ComponentManager
     {
     public:
         void init()
         {
-            m_component_arrays = std::unordered_map<const char*, std::shared_ptr<IComponentArray>>();
-            m_component_types = std::unordered_map<const char*, ComponentType>();
-            m_next_component_type = 0;
+            m_component_arrays = std::vector<std::unique_ptr<IComponentArray>>();
+        }
+
+        void on_entity_destroyed(EntityID a_id)
+        {
+            for(auto& array : m_component_arrays)
+            {
+                if(array)
+                {
+                    array->on_entity_destroyed(a_id);
+                }
+            }
         }
 
-        void on_entity_destroyed(std::uint16_t a_id)
+        //Views sort arrays on demand, doing it up front keeps them read only while systems run in parallel.
+        void sort_arrays()
         {
-            for(auto& comp_pair : m_component_arrays)
+            for(auto& array : m_component_arrays)
             {
-                auto& array = comp_pair.second;
-                array->on_entity_destroyed(a_id);
+                if(array)
+                {
+                    array->sort();
+                }
             }
         }
 
         template<typename T>
         void register_component()
         {
-            const char* component_name = typeid(T).name();
+            std::uint32_t id = get_component_id<T>();
+
+            if(id >= MAX_COMPONENTS)
+            {
+                LOG_ERROR("Can't register component: {0}, MAX_COMPONENTS reached!", typeid(T).name());
+                return;
+            }
 
-            if(m_component_types.find(component_name) != m_component_types.end())
+            if(id < m_component_arrays.size() && m_component_arrays[id])
             {
-                LOG_WARNING("Trying to register component: {0} more than once!", component_name);
+                LOG_WARNING("Trying to register component: {0} more than once!", typeid(T).name());
                 return;
             }
 
-            m_component_arrays.insert({component_name, std::make_shared<ComponentArray<T>>()});
-            m_component_types.insert({component_name, m_next_component_type});
+            if(id >= m_component_arrays.size())
+            {
+                m_component_arrays.resize(id + 1);
+            }
+
+            if constexpr(is_tag_v<T>)
+            {
+                static_assert(std::is_empty_v<T>, "Tags can't have data members");
+
+                m_component_arrays[id] = std::make_unique<TagArray>();
+                m_tag_mask.set(id, true);
+            }
+            else
+            {
+                m_component_arrays[id] = std::make_unique<ComponentArray<T>>();
+            }
+        }
+
+        bool is_tag(ComponentType a_type) const
+        {
+            return a_type < MAX_COMPONENTS && m_tag_mask.test(a_type);
+        }
 
-            m_next_component_type++;
+        TagArray* get_tag_array(ComponentType a_type)
+        {
+            return is_tag(a_type) ? static_cast<TagArray*>(m_component_arrays[a_type].get()) : nullptr;
         }
 
+        //Clears every tag of a_signature carried by a_id, used when components live outside of ComponentManager.
+        void remove_tags(EntityID a_id, const Signature& a_signature)
+        {
+            Signature tags = a_signature & m_tag_mask;
+
+            for(size_t type = 0; tags.any() && type < MAX_COMPONENTS; type++)
+            {
+                if(tags.test(type))
+                {
+                    get_tag_array(static_cast<ComponentType>(type))->reset(a_id);
+                    tags.reset(type);
+                }
+            }
+        }
+
+        //Component type is the dense component id, it doubles as the bit of the component in Signature.
         template<typename T>
         ComponentType get_component_type()
         {
-            const char* component_name = typeid(T).name();
+            std::uint32_t id = get_component_id<T>();
 
-            if(m_component_types.find(component_name) == m_component_types.end())
+            if(id >= m_component_arrays.size() || !m_component_arrays[id])
             {
-                LOG_WARNING("Component: {0} not registered before use!", component_name);
+                LOG_WARNING("Component: {0} not registered before use!", typeid(T).name());
                 return 0;
             }
 
-            return m_component_types[component_name];
+            return static_cast<ComponentType>(id);
         }
 
         template<typename T>
-        void add_component(std::uint16_t a_id, T& a_component)
+        void add_component(EntityID a_id, T& a_component)
         {
             get_component_array<T>()->add_data(a_id, a_component);
         }
 
         template<typename T>
-        void remove_component(std::uint16_t a_id)
+        void remove_component(EntityID a_id)
         {
             get_component_array<T>()->remove_data(a_id);
         }
 
         template<typename T>
-        T& get_component(std::uint16_t a_id)
+        T& get_component(EntityID a_id)
         {
             return get_component_array<T>()->get_data(a_id);
         }
-    private:
+
         template<typename T>
-        std::shared_ptr<ComponentArray<T>> get_component_array()
+        ComponentArray<T>* get_component_array()
         {
-            const char* component_name = typeid(T).name();
+            static_assert(!is_tag_v<T>, "Tags have no component array, use get_tag_array");
+
+            std::uint32_t id = get_component_id<T>();
 
-            if(m_component_arrays.find(component_name) == m_component_arrays.end())
+            if(id >= m_component_arrays.size())
             {
-                //LOG_WARNING("Failed to retrieve ComponentArray of type: {0}. Component maybe be not registered before use!", component_name);
                 return nullptr;
             }
 
-            return std::static_pointer_cast<ComponentArray<T>>(m_component_arrays[component_name]);
+            return static_cast<ComponentArray<T>*>(m_component_arrays[id].get());
         }
+
+        IComponentArray* get_component_array(ComponentType a_type)
+        {
+            return a_type < m_component_arrays.size() ? m_component_arrays[a_type].get() : nullptr;
+        }
+
+        //One clone per registered array, indexed like m_component_arrays. Clones share storage with the arrays.
+        std::vector<std::unique_ptr<IComponentArray>> take_snapshot() const
+        {
+            std::vector<std::unique_ptr<IComponentArray>> snapshot(m_component_arrays.size());
+
+            for(size_t i = 0; i < m_component_arrays.size(); i++)
+            {
+                if(m_component_arrays[i])
+                {
+                    snapshot[i] = m_component_arrays[i]->clone();
+                }
+            }
+
+            return snapshot;
+        }
+
+        //Arrays keep their identity, so pointers to them stay valid. Ones registered after the snapshot are emptied.
+        void restore(const std::vector<std::unique_ptr<IComponentArray>>& a_snapshot)
+        {
+            for(size_t i = 0; i < m_component_arrays.size(); i++)
+            {
+                if(m_component_arrays[i])
+                {
+                    m_component_arrays[i]->restore(i < a_snapshot.size() ? a_snapshot[i].get() : nullptr);
+                }
+            }
+        }
+
+        ObserverId add_observer(ComponentType a_type, ComponentObserver a_observer)
+        {
+            if(a_type >= MAX_COMPONENTS)
+            {
+                LOG_ERROR("Can't observe component type: {0}", a_type);
+                return INVALID_OBSERVER;
+            }
+
+            if(a_type >= m_observed_types.size())
+            {
+                m_observed_types.resize(a_type + 1);
+            }
+
+            if(!m_observed_mask.test(a_type))
+            {
+                m_observed_mask.set(a_type, true);
+                m_observed_list.push_back(a_type);
+            }
+
+            ObserverId id = m_next_observer++;
+            m_observed_types[a_type].m_observers.emplace_back(id, std::move(a_observer));
+
+            return id;
+        }
+
+        void remove_observer(ObserverId a_id)
+        {
+            for(ComponentType type : m_observed_list)
+            {
+                auto& observers = m_observed_types[type].m_observers;
+                observers.erase(std::remove_if(observers.begin(), observers.end(), [a_id](const auto& a_observer) {
+                    return a_observer.first == a_id;
+                }), observers.end());
+            }
+        }
+
+        bool has_observer(ComponentType a_type, ObserverId a_id) const
+        {
+            const auto& observers = m_observed_types[a_type].m_observers;
+
+            return std::any_of(observers.begin(), observers.end(), [a_id](const auto& a_observer) {
+                return a_observer.first == a_id;
+            });
+        }
+
+        //Remembers which observed components a_id gained or lost, nothing is delivered before dispatch_events.
+        void record_changes(EntityID a_id, const Signature& a_old_signature, const Signature& a_new_signature)
+        {
+            record_changes(&a_id, 1, a_old_signature, a_new_signature);
+        }
+
+        void record_changes(const std::vector<SignatureChange>& a_changes)
+        {
+            for(const SignatureChange& change : a_changes)
+            {
+                record_changes(&change.m_entity, 1, change.m_old_signature, change.m_new_signature);
+            }
+        }
+
+        //Same change for every entity of a_ids.
+        void record_changes(const EntityID* a_ids, size_t a_count, const Signature& a_old_signature, const Signature& a_new_signature)
+        {
+            Signature changed = (a_old_signature ^ a_new_signature) & m_observed_mask;
+            if(changed.none())
+            {
+                return;
+            }
+
+            for(ComponentType type : m_observed_list)
+            {
+                if(!changed.test(type))
+                {
+                    continue;
+                }
+
+                auto& events = m_observed_types[type].m_events;
+                bool had = a_old_signature.test(type);
+
+                for(size_t i = 0; i < a_count; i++)
+                {
+                    events.push_back(RecordedEvent{ .m_entity = a_ids[i], .m_had_component = had });
+                }
+            }
+        }
+
+        //Sync point, hands every observer one batch per observed type. An entity is reported by comparing whether
+        //it owned the component before its first recorded change and whether a_owns(entity, type) holds now.
+        //Changes made by observers are delivered on the next dispatch.
+        template<typename F>
+        void dispatch_events(F&& a_owns)
+        {
+            //Observers may observe new types, which grows both observed vectors. Types are walked by index up to the
+            //count from before dispatch and nothing of m_observed_types is held while observers run.
+            size_t observed_count = m_observed_list.size();
+            for(size_t i = 0; i < observed_count; i++)
+            {
+                ComponentType type = m_observed_list[i];
+                ObservedType& observed = m_observed_types[type];
+                if(observed.m_events.empty())
+                {
+                    continue;
+                }
+
+                std::vector<RecordedEvent> events;
+                events.swap(observed.m_events);
+
+                std::stable_sort(events.begin(), events.end(), [](const RecordedEvent& a_lhs, const RecordedEvent& a_rhs) {
+                    return a_lhs.m_entity < a_rhs.m_entity;
+                });
+
+                ComponentEvents batch{ .m_type = type };
+                for(size_t event = 0; event < events.size(); event++)
+                {
+                    if(event > 0 && events[event].m_entity == events[event - 1].m_entity)
+                    {
+                        continue;
+                    }
+
+                    bool owns = a_owns(events[event].m_entity, type);
+                    if(events[event].m_had_component)
+                    {
+                        batch.m_removed.push_back(events[event].m_entity);
+                    }
+                    if(owns)
+                    {
+                        batch.m_added.push_back(events[event].m_entity);
+                    }
+                }
+
+                if(batch.m_added.empty() && batch.m_removed.empty())
+                {
+                    continue;
+                }
+
+                auto observers = observed.m_observers;
+                for(const auto& [id, observer] : observers)
+                {
+                    //An earlier observer may have removed this one, its owner could be gone already.
+                    if(has_observer(type, id))
+                    {
+                        observer(batch);
+                    }
+                }
+            }
+        }
+    private:
+        struct RecordedEvent
+        {
+            EntityID m_entity;
+            bool     m_had_component;
+        };
+
+        struct ObservedType
+        {
+            std::vector<std::pair<ObserverId, ComponentObserver>> m_observers;
+            std::vector<RecordedEvent>                            m_events;
+        };
     private:
-        std::unordered_map<const char*, std::shared_ptr<IComponentArray>> m_component_arrays;
-        std::unordered_map<const char*, ComponentType> m_component_types;
-        ComponentType m_next_component_type;
+        std::vector<std::unique_ptr<IComponentArray>> m_component_arrays;
+        Signature                                     m_tag_mask;
+
+        std::vector<ObservedType>  m_observed_types;
+        std::vector<ComponentType> m_observed_list;
+        Signature                  m_observed_mask;
+        ObserverId                 m_next_observer = 0;
     };
 }
 
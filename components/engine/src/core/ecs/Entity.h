@@ -5,7 +5,7 @@
 #ifndef MAIN_ENTITY_H
 #define MAIN_ENTITY_H
 
-#include <string>
+#include <string_view>
 
 #include "Types.h"
 
@@ -22,23 +22,21 @@ namespace vis
         BUFFER_FULL
     };
 
+    //Metadata of a single entity as returned by EntityManager. Cheap to copy, the name points into the
+    //StringPool of the manager and stays valid after the entity is gone.
     class Entity
     {
     public:
-        Entity(std::uint16_t a_id);
-        Entity(std::uint64_t a_id, const std::string& a_name, EntityType a_type);
-        void set_type(EntityType a_type);
+        Entity(EntityID a_id, std::string_view a_name, EntityType a_type);
 
-        std::uint64_t get_id() const;
-        std::string get_name() const;
+        EntityID get_id() const;
+        std::string_view get_name() const;
         EntityType get_type() const;
     private:
-        std::string m_name;
-        std::uint64_t m_id;
+        EntityID m_id;
+        std::string_view m_name;
 
         EntityType m_type;
-
-        static int m_next_entity_suffix;
     };
 }
 
@@ -5,81 +5,408 @@
 #include "EntityManager.h"
 #include "Logger.h"
 
+#include <algorithm>
+#include <charconv>
+
+#define DEFAULT_NAME "default"
+
 namespace vis
 {
 
     void EntityManager::init()
     {
-        m_available_entities = std::queue<std::uint16_t>();
-        m_signatures = std::array<Signature, MAX_ENTITIES>();
+        m_available_pages = std::vector<std::shared_ptr<IndexPage>>();
+        m_available_begin = 0;
+        m_available_end = 0;
+        m_pages = std::vector<std::shared_ptr<EntityPage>>();
+        m_next_index = 0;
         m_living_entities = 0;
+        m_next_name_suffix = 0;
+    }
+
+    EntityID EntityManager::create_entity()
+    {
+        std::uint32_t index;
 
-        for(std::uint16_t i = 0; i < MAX_ENTITIES; i++)
+        //Freed slots are reused in FIFO order, so a single slot wraps its generation as late as possible.
+        if(has_available_index())
         {
-            m_available_entities.push(i);
+            index = pop_available_index();
         }
+        else
+        {
+            if(m_next_index >= MAX_ENTITIES)
+            {
+                LOG_ERROR("Maximum entities count reached!");
+                return NULL_ENTITY;
+            }
+
+            index = m_next_index++;
+            get_page(index).m_generations[index % ENTITY_PAGE_SIZE] = 0;
+        }
+
+        EntityID id = make_entity_id(index, read_page(index).m_generations[index % ENTITY_PAGE_SIZE]);
+        init_metadata(index);
+        m_living_entities++;
+
+        return id;
     }
 
-    std::uint16_t EntityManager::create_entity()
+    std::vector<EntityID> EntityManager::create_entities(size_t a_count, const Signature& a_signature)
     {
-        if(m_living_entities >= MAX_ENTITIES)
+        std::vector<EntityID> ids;
+        ids.reserve(a_count);
+
+        while(ids.size() < a_count && has_available_index())
+        {
+            std::uint32_t index = pop_available_index();
+
+            ids.push_back(make_entity_id(index, read_page(index).m_generations[index % ENTITY_PAGE_SIZE]));
+        }
+
+        size_t fresh = a_count - ids.size();
+        if(fresh > MAX_ENTITIES - m_next_index)
         {
             LOG_ERROR("Maximum entities count reached!");
-            return MAX_ENTITIES;
+            fresh = MAX_ENTITIES - m_next_index;
         }
 
-        std::uint16_t id = m_available_entities.front();
-        m_entities.insert({id, Entity(id)});
-        m_available_entities.pop();
-        m_living_entities++;
+        for(size_t i = 0; i < fresh; i++)
+        {
+            std::uint32_t index = m_next_index++;
+            get_page(index).m_generations[index % ENTITY_PAGE_SIZE] = 0;
 
-        return id;
+            ids.push_back(make_entity_id(index, 0));
+        }
+
+        std::sort(ids.begin(), ids.end());
+
+        for(EntityID id : ids)
+        {
+            std::uint32_t index = get_entity_index(id);
+
+            get_page(index).m_signatures[index % ENTITY_PAGE_SIZE] = a_signature;
+            init_metadata(index);
+        }
+
+        m_living_entities += static_cast<std::uint32_t>(ids.size());
+
+        return ids;
     }
 
-    Entity EntityManager::get_entity(std::uint16_t a_id)
+    Entity EntityManager::get_entity(EntityID a_id)
     {
-        if(m_entities.find(a_id) == m_entities.end())
+        if(!is_alive(a_id))
         {
             LOG_ERROR("Trying to access non existing entity");
-            return {MAX_ENTITIES};
+            return {NULL_ENTITY, {}, EntityType::UNINITIALIZED};
         }
 
-        return m_entities.at(a_id);
+        return {a_id, get_name(a_id), get_type(a_id)};
     }
 
-    void EntityManager::on_entity_destroyed(std::uint16_t a_id)
+    void EntityManager::on_entity_destroyed(EntityID a_id)
     {
-        if(a_id < 0 || a_id > MAX_ENTITIES)
+        if(!is_alive(a_id))
         {
-            LOG_ERROR("Can't destroy entity! Passed ID out of range.");
+            LOG_ERROR("Can't destroy entity! Passed ID is not alive.");
             return;
         }
 
-        m_available_entities.push(a_id);
-        m_entities.erase(a_id);
-        m_signatures[a_id].reset();
+        std::uint32_t index = get_entity_index(a_id);
+        EntityPage& page = get_page(index);
+
+        page.m_signatures[index % ENTITY_PAGE_SIZE].reset();
+        page.m_generations[index % ENTITY_PAGE_SIZE] = (get_entity_generation(a_id) + 1) % PENDING_ENTITY_GENERATION;
+
+        push_available_index(index);
         m_living_entities--;
     }
 
-    Signature EntityManager::get_signature(std::uint16_t a_id)
+    bool EntityManager::is_alive(EntityID a_id) const
+    {
+        std::uint32_t index = get_entity_index(a_id);
+
+        if(a_id == NULL_ENTITY || index >= m_next_index)
+        {
+            return false;
+        }
+
+        const EntityPage& page = *m_pages[index / ENTITY_PAGE_SIZE];
+
+        //Destroying bumps the generation right away, so freed slots never match.
+        return page.m_generations[index % ENTITY_PAGE_SIZE] == get_entity_generation(a_id);
+    }
+
+    EntityID EntityManager::get_id(std::uint32_t a_index) const
+    {
+        if(a_index >= m_next_index)
+        {
+            return NULL_ENTITY;
+        }
+
+        return make_entity_id(a_index, read_page(a_index).m_generations[a_index % ENTITY_PAGE_SIZE]);
+    }
+
+    Signature EntityManager::get_signature(EntityID a_id)
     {
-        if(a_id < 0 || a_id > MAX_ENTITIES)
+        if(!is_alive(a_id))
         {
-            LOG_ERROR("Can't get entity signature! Passed ID out of range.");
+            LOG_ERROR("Can't get entity signature! Passed ID is not alive.");
             return {};
         }
 
-        return m_signatures[a_id];
+        std::uint32_t index = get_entity_index(a_id);
+
+        return read_page(index).m_signatures[index % ENTITY_PAGE_SIZE];
+    }
+
+    void EntityManager::set_signature(EntityID a_id, Signature& a_signature)
+    {
+        if(!is_alive(a_id))
+        {
+            LOG_ERROR("Can't set entity signature! Passed ID is not alive.");
+            return;
+        }
+
+        std::uint32_t index = get_entity_index(a_id);
+
+        get_page(index).m_signatures[index % ENTITY_PAGE_SIZE] = a_signature;
+    }
+
+    std::vector<EntityID> EntityManager::get_matching_entities(const Signature& a_signature)
+    {
+        std::vector<EntityID> entities;
+
+        if(a_signature.none())
+        {
+            return entities;
+        }
+
+        for(std::uint32_t i = 0; i < m_next_index; i++)
+        {
+            const EntityPage& page = *m_pages[i / ENTITY_PAGE_SIZE];
+
+            if((page.m_signatures[i % ENTITY_PAGE_SIZE] & a_signature) == a_signature)
+            {
+                entities.push_back(make_entity_id(i, page.m_generations[i % ENTITY_PAGE_SIZE]));
+            }
+        }
+
+        return entities;
+    }
+
+    std::string_view EntityManager::get_name(EntityID a_id)
+    {
+        if(!is_alive(a_id))
+        {
+            LOG_ERROR("Can't get entity name! Passed ID is not alive.");
+            return {};
+        }
+
+        std::uint32_t index = get_entity_index(a_id);
+        const EntityPage& page = read_page(index);
+        StringId name = page.m_names[index % ENTITY_PAGE_SIZE];
+
+        //Page is left untouched so reading a name never copies one shared with a snapshot.
+        if(name == INVALID_STRING_ID)
+        {
+            char buffer[32] = DEFAULT_NAME;
+            size_t prefix = sizeof(DEFAULT_NAME) - 1;
+            char* end = std::to_chars(buffer + prefix, buffer + sizeof(buffer), page.m_name_suffixes[index % ENTITY_PAGE_SIZE]).ptr;
+
+            name = m_names.intern(std::string_view(buffer, end - buffer));
+        }
+
+        return m_names.get(name);
     }
 
-    void EntityManager::set_signature(std::uint16_t a_id, Signature& a_signature)
+    void EntityManager::set_name(EntityID a_id, std::string_view a_name)
     {
-        if(a_id < 0 || a_id > MAX_ENTITIES)
+        if(!is_alive(a_id))
         {
-            LOG_ERROR("Can't set entity signature! Passed ID out of range.");
+            LOG_ERROR("Can't set entity name! Passed ID is not alive.");
             return;
         }
 
-        m_signatures[a_id] = a_signature;
+        std::uint32_t index = get_entity_index(a_id);
+
+        get_page(index).m_names[index % ENTITY_PAGE_SIZE] = m_names.intern(a_name);
+    }
+
+    EntityType EntityManager::get_type(EntityID a_id) const
+    {
+        if(!is_alive(a_id))
+        {
+            LOG_ERROR("Can't get entity type! Passed ID is not alive.");
+            return EntityType::UNINITIALIZED;
+        }
+
+        std::uint32_t index = get_entity_index(a_id);
+
+        return read_page(index).m_types[index % ENTITY_PAGE_SIZE];
+    }
+
+    void EntityManager::set_type(EntityID a_id, EntityType a_type)
+    {
+        if(!is_alive(a_id))
+        {
+            LOG_ERROR("Can't set entity type! Passed ID is not alive.");
+            return;
+        }
+
+        std::uint32_t index = get_entity_index(a_id);
+
+        get_page(index).m_types[index % ENTITY_PAGE_SIZE] = a_type;
+    }
+
+    //Suffix is taken at creation, so default names keep numbering entities in creation order.
+    void EntityManager::init_metadata(std::uint32_t a_index)
+    {
+        EntityPage& page = get_page(a_index);
+
+        page.m_names[a_index % ENTITY_PAGE_SIZE] = INVALID_STRING_ID;
+        page.m_name_suffixes[a_index % ENTITY_PAGE_SIZE] = m_next_name_suffix++;
+        page.m_types[a_index % ENTITY_PAGE_SIZE] = EntityType::UNINITIALIZED;
+    }
+
+    EntityManager::EntityPage& EntityManager::get_page(std::uint32_t a_index)
+    {
+        size_t page = a_index / ENTITY_PAGE_SIZE;
+
+        if(page >= m_pages.size())
+        {
+            m_pages.resize(page + 1);
+        }
+
+        if(!m_pages[page])
+        {
+            m_pages[page] = std::make_shared<EntityPage>();
+        }
+        else if(m_pages[page].use_count() > 1)
+        {
+            m_pages[page] = std::make_shared<EntityPage>(*m_pages[page]);
+        }
+
+        return *m_pages[page];
+    }
+
+    const EntityManager::EntityPage& EntityManager::read_page(std::uint32_t a_index) const
+    {
+        return *m_pages[a_index / ENTITY_PAGE_SIZE];
+    }
+
+    bool EntityManager::has_available_index() const
+    {
+        return m_available_begin != m_available_end;
+    }
+
+    void EntityManager::push_available_index(std::uint32_t a_index)
+    {
+        size_t page = m_available_end / ENTITY_PAGE_SIZE;
+
+        if(page >= m_available_pages.size())
+        {
+            m_available_pages.push_back(std::make_shared<IndexPage>());
+        }
+        else if(m_available_pages[page].use_count() > 1)
+        {
+            m_available_pages[page] = std::make_shared<IndexPage>(*m_available_pages[page]);
+        }
+
+        m_available_pages[page]->m_indices[m_available_end % ENTITY_PAGE_SIZE] = a_index;
+        m_available_end++;
+    }
+
+    std::uint32_t EntityManager::pop_available_index()
+    {
+        std::uint32_t index = m_available_pages.front()->m_indices[m_available_begin++];
+
+        if(m_available_begin == m_available_end)
+        {
+            m_available_pages.clear();
+            m_available_begin = 0;
+            m_available_end = 0;
+        }
+        else if(m_available_begin == ENTITY_PAGE_SIZE)
+        {
+            m_available_pages.erase(m_available_pages.begin());
+            m_available_begin = 0;
+            m_available_end -= ENTITY_PAGE_SIZE;
+        }
+
+        return index;
+    }
+
+    EntityManager::Snapshot EntityManager::take_snapshot() const
+    {
+        return Snapshot{
+            .m_pages = m_pages,
+            .m_available_pages = m_available_pages,
+            .m_available_begin = m_available_begin,
+            .m_available_end = m_available_end,
+            .m_next_index = m_next_index,
+            .m_living_entities = m_living_entities,
+            .m_next_name_suffix = m_next_name_suffix
+        };
+    }
+
+    std::vector<SignatureChange> EntityManager::restore(const Snapshot& a_snapshot)
+    {
+        std::vector<SignatureChange> changes;
+        size_t page_count = std::max(m_pages.size(), a_snapshot.m_pages.size());
+
+        for(size_t page = 0; page < page_count; page++)
+        {
+            const EntityPage* current = page < m_pages.size() ? m_pages[page].get() : nullptr;
+            const EntityPage* restored = page < a_snapshot.m_pages.size() ? a_snapshot.m_pages[page].get() : nullptr;
+
+            if(current == restored)
+            {
+                continue;
+            }
+
+            //Slots past the last index ever used, destroyed ones included, have an empty signature.
+            for(std::uint32_t slot = 0; slot < ENTITY_PAGE_SIZE; slot++)
+            {
+                auto index = static_cast<std::uint32_t>(page * ENTITY_PAGE_SIZE + slot);
+                Signature current_signature = current && index < m_next_index ? current->m_signatures[slot] : Signature();
+                Signature restored_signature = restored && index < a_snapshot.m_next_index ? restored->m_signatures[slot] : Signature();
+                EntityID current_id = make_entity_id(index, current ? current->m_generations[slot] : 0);
+                EntityID restored_id = make_entity_id(index, restored ? restored->m_generations[slot] : 0);
+
+                if(current_id == restored_id)
+                {
+                    if(current_signature != restored_signature)
+                    {
+                        changes.push_back(SignatureChange{ current_id, current_signature, restored_signature });
+                    }
+                    continue;
+                }
+
+                if(current_signature.any())
+                {
+                    changes.push_back(SignatureChange{ current_id, current_signature, Signature() });
+                }
+                if(restored_signature.any())
+                {
+                    changes.push_back(SignatureChange{ restored_id, Signature(), restored_signature });
+                }
+            }
+        }
+
+        std::sort(changes.begin(), changes.end(), [](const SignatureChange& a_lhs, const SignatureChange& a_rhs) {
+            return a_lhs.m_entity < a_rhs.m_entity;
+        });
+
+        m_pages = a_snapshot.m_pages;
+        m_available_pages = a_snapshot.m_available_pages;
+        m_available_begin = a_snapshot.m_available_begin;
+        m_available_end = a_snapshot.m_available_end;
+        m_next_index = a_snapshot.m_next_index;
+        m_living_entities = a_snapshot.m_living_entities;
+        m_next_name_suffix = a_snapshot.m_next_name_suffix;
+
+        return changes;
     }
-}
\ No newline at end of file
+}
@@ -5,32 +5,103 @@
 #ifndef MAIN_ENTITYMANAGER_H
 #define MAIN_ENTITYMANAGER_H
 
-#include <queue>
 #include <array>
-#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <string_view>
 
 #include "Types.h"
 #include "Entity.h"
+#include "StringPool.h"
 
 namespace vis
 {
     class EntityManager
     {
+        struct EntityPage;
+        struct IndexPage;
     public:
+        //State of the whole entity table, pages of entities and of free indices are shared with the manager and
+        //copied by whichever side writes to one first. Names stay valid since the string pool only ever grows.
+        struct Snapshot
+        {
+            std::vector<std::shared_ptr<EntityPage>> m_pages;
+            std::vector<std::shared_ptr<IndexPage>>  m_available_pages;
+            std::uint32_t                            m_available_begin;
+            std::uint32_t                            m_available_end;
+            std::uint32_t                            m_next_index;
+            std::uint32_t                            m_living_entities;
+            std::uint32_t                            m_next_name_suffix;
+        };
+
         void init();
 
-        std::uint16_t create_entity();
-        Entity get_entity(std::uint16_t a_id);
-        void on_entity_destroyed(std::uint16_t a_id);
+        EntityID create_entity();
+
+        //Creates a_count entities sharing a_signature, returned handles are sorted.
+        std::vector<EntityID> create_entities(size_t a_count, const Signature& a_signature);
+        Entity get_entity(EntityID a_id);
+        void on_entity_destroyed(EntityID a_id);
+        bool is_alive(EntityID a_id) const;
+
+        //Handle of whatever occupies slot a_index now, a destroyed one if the slot is free.
+        EntityID get_id(std::uint32_t a_index) const;
+
+        Signature get_signature(EntityID a_id);
+        void set_signature(EntityID a_id, Signature& a_signature);
+
+        std::vector<EntityID> get_matching_entities(const Signature& a_signature);
+
+        //Name view stays valid after renaming or destroying the entity. Entities which were never named
+        //are called "default" followed by a number, that name is interned in the pool but not stored in the entity.
+        std::string_view get_name(EntityID a_id);
+        void set_name(EntityID a_id, std::string_view a_name);
+
+        EntityType get_type(EntityID a_id) const;
+        void set_type(EntityID a_id, EntityType a_type);
+
+        Snapshot take_snapshot() const;
+
+        //Returns how signatures of handles differ between the current state and a_snapshot, sorted by handle.
+        //Only pages not shared with the snapshot are compared, entities are reported as changing to or
+        //from an empty signature when their slot holds a different generation.
+        std::vector<SignatureChange> restore(const Snapshot& a_snapshot);
+    private:
+        //Slots are allocated a page at a time, capacity grows with the highest index ever used.
+        struct EntityPage
+        {
+            std::array<Signature, ENTITY_PAGE_SIZE>     m_signatures;
+            std::array<std::uint16_t, ENTITY_PAGE_SIZE> m_generations;
+            std::array<StringId, ENTITY_PAGE_SIZE>      m_names;
+            std::array<std::uint32_t, ENTITY_PAGE_SIZE> m_name_suffixes;
+            std::array<EntityType, ENTITY_PAGE_SIZE>    m_types;
+        };
+
+        //Free indices form a FIFO spread over pages, m_available_begin and m_available_end count slots from the
+        //start of the first page. Pages are dropped once read, so a snapshot only holds the not yet reused ones.
+        struct IndexPage
+        {
+            std::array<std::uint32_t, ENTITY_PAGE_SIZE> m_indices;
+        };
+
+        bool has_available_index() const;
+        void push_available_index(std::uint32_t a_index);
+        std::uint32_t pop_available_index();
 
-        Signature get_signature(std::uint16_t a_id);
-        void set_signature(std::uint16_t a_id, Signature& a_signature);
+        //Page for writing, copied first when a snapshot still shares it.
+        EntityPage& get_page(std::uint32_t a_index);
+        const EntityPage& read_page(std::uint32_t a_index) const;
+        void init_metadata(std::uint32_t a_index);
     private:
-        std::queue<std::uint16_t> m_available_entities;
-        std::array<Signature, MAX_ENTITIES> m_signatures;
-        std::unordered_map<std::uint16_t, Entity> m_entities;
+        std::vector<std::shared_ptr<IndexPage>> m_available_pages;
+        std::uint32_t m_available_begin;
+        std::uint32_t m_available_end;
+        std::vector<std::shared_ptr<EntityPage>> m_pages;
+        StringPool m_names;
 
-        std::uint16_t m_living_entities;
+        std::uint32_t m_next_index;
+        std::uint32_t m_living_entities;
+        std::uint32_t m_next_name_suffix;
     };
 }
 
@@ -7,81 +7,559 @@
 
 #include <memory>
 #include <set>
+#include <algorithm>
+#include <functional>
+#include <bit>
+#include <tuple>
 
 #include "EntityManager.h"
 #include "ComponentManager.h"
+#include "ArchetypeStorage.h"
 #include "SystemManager.h"
+#include "View.h"
+#include "CommandBuffer.h"
+#include "Reflection.h"
+#include "Logger.h"
 
+#define TAG_QUERY_BLOCK 64
 
 namespace vis
 {
-    class MainManager
+    //Marks tags narrowing a view, see MainManager::view.
+    template<typename... Tags>
+    struct Tagged {};
+
+    //Component storage used by MainManager, both keep the same public API so they can be benchmarked against each other.
+    enum class StorageBackend
+    {
+        SPARSE_SET,
+        ARCHETYPE
+    };
+
+    //Copy on write image of every entity and component. Taking and restoring one only copies page pointers,
+    //storage is copied when the world or the snapshot writes to it afterwards.
+    struct WorldSnapshot
+    {
+        EntityManager::Snapshot                       m_entities;
+        std::vector<std::unique_ptr<IComponentArray>> m_components;
+    };
+
+    class MainManager;
+
+    //Component observer registered by MainManager::observe, removed when the handle is destroyed or reset.
+    //Holds the manager weakly, so it can outlive it, e.g. in a system kept alive after MainManager::init.
+    class ObserverHandle
+    {
+    public:
+        ObserverHandle() = default;
+        ObserverHandle(std::weak_ptr<MainManager> a_main_manager, ObserverId a_id);
+        ObserverHandle(ObserverHandle&& a_other) noexcept;
+        ObserverHandle& operator=(ObserverHandle&& a_other) noexcept;
+        ObserverHandle(const ObserverHandle& a_other) = delete;
+        ObserverHandle& operator=(const ObserverHandle& a_other) = delete;
+        ~ObserverHandle();
+
+        void reset();
+    private:
+        std::weak_ptr<MainManager> m_main_manager;
+        ObserverId                 m_id = INVALID_OBSERVER;
+    };
+
+    class MainManager : public std::enable_shared_from_this<MainManager>
     {
     public:
         MainManager() = default;
         MainManager(const MainManager& a_other) = delete;
         MainManager& operator=(const MainManager a_other) = delete;
 
-        static void init()
+        static void init(StorageBackend a_backend = StorageBackend::SPARSE_SET)
         {
             m_instance = std::make_shared<MainManager>();
-            m_instance->create_managers();
+            m_instance->create_managers(a_backend);
         }
 
-        std::uint16_t create_entity()
+        EntityID create_entity()
         {
             return m_entity_manager->create_entity();
         }
 
-        void destroy_entity(std::uint16_t a_id)
+        //Creates a_count entities owning copies of a_components. Ids are reserved in one go, components are written
+        //in bulk and systems are updated once for the whole batch. Returned handles are sorted.
+        template<typename... Ts>
+        std::vector<EntityID> create_entities(size_t a_count, const Ts&... a_components)
         {
+            Signature signature = make_signature<Ts...>();
+            std::vector<EntityID> ids = m_entity_manager->create_entities(a_count, signature);
+
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                add_to_archetypes(ids, a_components...);
+            }
+
+            (add_bulk(ids, a_components), ...);
+
+            m_component_manager->record_changes(ids.data(), ids.size(), Signature(), signature);
+            m_system_manager->on_entities_created(ids, signature);
+
+            return ids;
+        }
+
+        void destroy_entity(EntityID a_id)
+        {
+            if(!m_entity_manager->is_alive(a_id))
+            {
+                LOG_WARNING("Trying to destroy stale entity: {0}", a_id);
+                return;
+            }
+
+            Signature signature = m_entity_manager->get_signature(a_id);
             m_entity_manager->on_entity_destroyed(a_id);
-            m_component_manager->on_entity_destroyed(a_id);
-            m_system_manager->on_entity_destroyed(a_id);
+
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                m_archetype_storage->on_entity_destroyed(a_id);
+                m_component_manager->remove_tags(a_id, signature);
+            }
+            else
+            {
+                m_component_manager->on_entity_destroyed(a_id);
+            }
+
+            m_component_manager->record_changes(a_id, signature, Signature());
+            m_system_manager->on_entity_destroyed(a_id, signature);
 
             if(m_current_entity == a_id)
             {
-                m_current_entity = MAX_ENTITIES + 1;
+                m_current_entity = NULL_ENTITY;
             }
         }
 
-        void set_current_entity(std::uint16_t a_id)
+        //New entity owning copies of every component of a_source.
+        EntityID clone_entity(EntityID a_source)
+        {
+            if(!m_entity_manager->is_alive(a_source))
+            {
+                LOG_WARNING("Trying to clone stale entity: {0}", a_source);
+                return NULL_ENTITY;
+            }
+
+            EntityID id = m_entity_manager->create_entity();
+            if(id == NULL_ENTITY)
+            {
+                return NULL_ENTITY;
+            }
+
+            Signature signature = m_entity_manager->get_signature(a_source);
+            for(size_t type = 0; type < MAX_COMPONENTS; type++)
+            {
+                if(!signature.test(type))
+                {
+                    continue;
+                }
+
+                if(m_backend == StorageBackend::ARCHETYPE && !m_component_manager->is_tag(static_cast<ComponentType>(type)))
+                {
+                    m_archetype_storage->copy_component(a_source, id, static_cast<ComponentType>(type));
+                }
+                else
+                {
+                    m_component_manager->get_component_array(static_cast<ComponentType>(type))->copy_data(a_source, id);
+                }
+            }
+
+            m_entity_manager->set_type(id, m_entity_manager->get_type(a_source));
+            m_entity_manager->set_signature(id, signature);
+            m_component_manager->record_changes(id, Signature(), signature);
+            m_system_manager->on_entity_signature_changed(id, Signature(), signature);
+
+            return id;
+        }
+
+        //Only the sparse set backend supports snapshots, returns nullptr for the archetype one.
+        std::unique_ptr<WorldSnapshot> take_snapshot()
+        {
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                LOG_WARNING("World snapshots are not supported by archetype storage!");
+                return nullptr;
+            }
+
+            return std::make_unique<WorldSnapshot>(WorldSnapshot{
+                .m_entities = m_entity_manager->take_snapshot(),
+                .m_components = m_component_manager->take_snapshot()
+            });
+        }
+
+        //Pending commands are dropped. Systems and views are updated only for entities whose slot differs from
+        //the snapshot, then every system gets on_world_restored.
+        void restore_snapshot(const WorldSnapshot& a_snapshot)
+        {
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                LOG_WARNING("World snapshots are not supported by archetype storage!");
+                return;
+            }
+
+            m_command_queue.reset();
+
+            std::vector<SignatureChange> changes = m_entity_manager->restore(a_snapshot.m_entities);
+            m_component_manager->restore(a_snapshot.m_components);
+            m_component_manager->record_changes(changes);
+            m_system_manager->on_entity_signatures_changed(changes);
+            m_system_manager->sync_memberships(*m_entity_manager);
+            m_system_manager->on_world_restored();
+
+            if(!m_entity_manager->is_alive(m_current_entity))
+            {
+                m_current_entity = NULL_ENTITY;
+            }
+        }
+
+        //False for handles of destroyed entities, even if their slot was reused since.
+        bool is_alive(EntityID a_id) const
+        {
+            return m_entity_manager->is_alive(a_id);
+        }
+
+        void set_current_entity(EntityID a_id)
         {
             m_current_entity = a_id;
         }
 
-        std::uint16_t get_current_entity() const
+        EntityID get_current_entity() const
         {
             return m_current_entity;
         }
 
-        Entity get_entity(std::uint16_t a_id)
+        Entity get_entity(EntityID a_id)
         {
             return m_entity_manager->get_entity(a_id);
         }
 
+        std::string_view get_entity_name(EntityID a_id)
+        {
+            return m_entity_manager->get_name(a_id);
+        }
+
+        void set_entity_name(EntityID a_id, std::string_view a_name)
+        {
+            m_entity_manager->set_name(a_id, a_name);
+        }
+
+        void set_entity_type(EntityID a_id, EntityType a_type)
+        {
+            m_entity_manager->set_type(a_id, a_type);
+        }
+
         template<typename T>
-        T& get_component(std::uint16_t a_id)
+        T& get_component(EntityID a_id)
         {
+            static_assert(!is_tag_v<T>, "Tags have no data, use has_tag");
+
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                return m_archetype_storage->get_component<T>(a_id, m_component_manager->get_component_type<T>());
+            }
+
             return m_component_manager->get_component<T>(a_id);
         }
 
         template<typename T>
-        void add_component(std::uint16_t a_id, T a_component)
+        void add_component(EntityID a_id, T a_component)
         {
-            m_component_manager->add_component<T>(a_id, a_component);
+            if(!m_entity_manager->is_alive(a_id))
+            {
+                LOG_WARNING("Trying to modify components of stale entity: {0}", a_id);
+                return;
+            }
 
-            Signature signature = m_entity_manager->get_signature(a_id);
-            signature.set(m_component_manager->get_component_type<T>(), true);
+            ComponentType type = m_component_manager->get_component_type<T>();
+
+            if constexpr(is_tag_v<T>)
+            {
+                m_component_manager->get_tag_array(type)->set(a_id);
+            }
+            else if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                m_archetype_storage->add_component<T>(a_id, type, a_component);
+            }
+            else
+            {
+                m_component_manager->add_component<T>(a_id, a_component);
+            }
+
+            Signature old_signature = m_entity_manager->get_signature(a_id);
+            Signature signature = old_signature;
+            signature.set(type, true);
 
             m_entity_manager->set_signature(a_id, signature);
-            m_system_manager->on_entity_signature_changed(a_id, signature);
+            m_component_manager->record_changes(a_id, old_signature, signature);
+            m_system_manager->on_entity_signature_changed(a_id, old_signature, signature);
+        }
+
+        template<typename T>
+        void remove_component(EntityID a_id)
+        {
+            if(!m_entity_manager->is_alive(a_id))
+            {
+                LOG_WARNING("Trying to modify components of stale entity: {0}", a_id);
+                return;
+            }
+
+            ComponentType type = m_component_manager->get_component_type<T>();
+
+            if constexpr(is_tag_v<T>)
+            {
+                m_component_manager->get_tag_array(type)->reset(a_id);
+            }
+            else if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                m_archetype_storage->remove_component(a_id, type);
+            }
+            else
+            {
+                m_component_manager->remove_component<T>(a_id);
+            }
+
+            Signature old_signature = m_entity_manager->get_signature(a_id);
+            Signature signature = old_signature;
+            signature.set(type, false);
+
+            m_entity_manager->set_signature(a_id, signature);
+            m_component_manager->record_changes(a_id, old_signature, signature);
+            m_system_manager->on_entity_signature_changed(a_id, old_signature, signature);
+        }
+
+        //Number of entities owning T.
+        template<typename T>
+        size_t get_component_count()
+        {
+            ComponentType type = m_component_manager->get_component_type<T>();
+
+            if(m_backend == StorageBackend::ARCHETYPE && !is_tag_v<T>)
+            {
+                return m_archetype_storage->get_component_count(type);
+            }
+
+            return m_component_manager->get_component_array(type)->size();
+        }
+
+        //Reflection data of a_type, nullptr for components without Reflect specialization.
+        const TypeInfo* get_type_info(ComponentType a_type) const
+        {
+            return m_reflection_registry.get_type(a_type);
+        }
+
+        const ReflectionRegistry& get_reflection_registry() const
+        {
+            return m_reflection_registry;
+        }
+
+        //Calls a_func(entities, count, data) for runs of packed a_type components, the whole dense array
+        //for the sparse set backend and every chunk holding the type for the archetype one.
+        template<typename F>
+        void each_component_run(ComponentType a_type, F&& a_func)
+        {
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                m_archetype_storage->each_column(a_type, [&a_func](const EntityID* a_entities, size_t a_count, const std::byte* a_column) {
+                    a_func(a_entities, a_count, static_cast<const void*>(a_column));
+                });
+                return;
+            }
+
+            IComponentArray* array = m_component_manager->get_component_array(a_type);
+            if(array && array->size() > 0)
+            {
+                array->sort();
+                a_func(array->entities(), array->size(), array->get_data_erased());
+            }
+        }
+
+        //Moves a_count packed components described by a_type out of a_data, one to every entity of a_ids.
+        //Sorted batches of entities not owning the type yet are appended in one go, systems are updated once.
+        void add_components_erased(const TypeInfo& a_type, const EntityID* a_ids, size_t a_count, void* a_data)
+        {
+            ComponentType type = a_type.m_component_type;
+            IComponentArray* array = m_component_manager->get_component_array(type);
+
+            if(!array)
+            {
+                LOG_WARNING("Component type: {0} not registered before use!", type);
+                return;
+            }
+
+            std::vector<size_t> accepted;
+            std::vector<SignatureChange> changes;
+            accepted.reserve(a_count);
+            changes.reserve(a_count);
+
+            for(size_t i = 0; i < a_count; i++)
+            {
+                if(!m_entity_manager->is_alive(a_ids[i]) || m_entity_manager->get_signature(a_ids[i])[type])
+                {
+                    LOG_WARNING("Can't add component: {0} to entity: {1}", a_type.m_name.data(), a_ids[i]);
+                    continue;
+                }
+
+                Signature old_signature = m_entity_manager->get_signature(a_ids[i]);
+                Signature signature = old_signature;
+                signature.set(type, true);
+                changes.push_back(SignatureChange{ .m_entity = a_ids[i], .m_old_signature = old_signature, .m_new_signature = signature });
+                m_entity_manager->set_signature(a_ids[i], signature);
+                accepted.push_back(i);
+            }
+
+            bool sorted = std::adjacent_find(a_ids, a_ids + a_count, std::greater_equal<EntityID>()) == a_ids + a_count;
+            auto* components = static_cast<std::byte*>(a_data);
+
+            if(m_backend == StorageBackend::SPARSE_SET && sorted && accepted.size() == a_count)
+            {
+                array->add_data_bulk_erased(a_ids, a_count, a_data);
+            }
+            else
+            {
+                for(size_t i : accepted)
+                {
+                    if(m_backend == StorageBackend::ARCHETYPE)
+                    {
+                        m_archetype_storage->add_component_erased(a_ids[i], type, components + i * a_type.m_size);
+                    }
+                    else
+                    {
+                        array->add_data_erased(a_ids[i], components + i * a_type.m_size);
+                    }
+                }
+            }
+
+            std::sort(changes.begin(), changes.end(), [](const SignatureChange& a_lhs, const SignatureChange& a_rhs) {
+                return a_lhs.m_entity < a_rhs.m_entity;
+            });
+            m_component_manager->record_changes(changes);
+            m_system_manager->on_entity_signatures_changed(changes);
+        }
+
+        //False for stale handles.
+        template<typename T>
+        bool has_tag(EntityID a_id)
+        {
+            static_assert(is_tag_v<T>, "Only types deriving from Tag are tags");
+
+            return m_entity_manager->is_alive(a_id) && m_component_manager->get_tag_array(m_component_manager->get_component_type<T>())->test(a_id);
+        }
+
+        //Calls a_func(EntityID) for every entity carrying all of Tags, in order of entity index. Tag bitsets are
+        //ANDed a block of words at a time and only set bits are visited, no signature or component is read.
+        template<typename... Tags, typename F>
+        void each_tagged(F&& a_func)
+        {
+            for_each_tag_block<Tags...>([this, &a_func](size_t a_first_word, const std::uint64_t* a_words, size_t a_count) {
+                for(size_t word = 0; word < a_count; word++)
+                {
+                    for(std::uint64_t bits = a_words[word]; bits; bits &= bits - 1)
+                    {
+                        auto index = static_cast<std::uint32_t>((a_first_word + word) * TAG_WORD_BITS + std::countr_zero(bits));
+                        a_func(m_entity_manager->get_id(index));
+                    }
+                }
+            });
+        }
+
+        //Number of entities carrying all of Tags.
+        template<typename... Tags>
+        size_t count_tagged()
+        {
+            size_t count = 0;
+            for_each_tag_block<Tags...>([&count](size_t a_first_word, const std::uint64_t* a_words, size_t a_count) {
+                for(size_t word = 0; word < a_count; word++)
+                {
+                    count += std::popcount(a_words[word]);
+                }
+            });
+
+            return count;
+        }
+
+        //View over cached list of all entities owning Ts.
+        template<typename... Ts>
+        View<Ts...> view()
+        {
+            static_assert(!(is_tag_v<Ts> || ...), "Tags have no data, filter by them with view<Ts...>(Tagged<Tags...>())");
+
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                return View<Ts...>(nullptr, m_archetype_storage.get(), {m_component_manager->get_component_type<Ts>()...});
+            }
+
+            Signature signature = make_signature<Ts...>();
+            m_system_manager->sync_memberships(*m_entity_manager);
+            const std::vector<EntityID>* entities = m_system_manager->get_view_entities(signature);
+
+            if(!entities)
+            {
+                entities = m_system_manager->add_view_entities(signature, m_entity_manager->get_matching_entities(signature));
+            }
+
+            return View<Ts...>(entities, m_component_manager->get_component_array<std::remove_const_t<Ts>>()...);
+        }
+
+        //View over cached list of entities owning Ts and carrying all of Tags. Tags only narrow the list,
+        //they are not passed to the callbacks.
+        template<typename... Ts, typename... Tags>
+        View<Ts...> view(Tagged<Tags...>)
+        {
+            static_assert(!(is_tag_v<Ts> || ...) && (is_tag_v<Tags> && ...), "Ts must be components and Tags tags");
+
+            Signature signature = make_signature<Ts..., Tags...>();
+            m_system_manager->sync_memberships(*m_entity_manager);
+            const std::vector<EntityID>* entities = m_system_manager->get_view_entities(signature);
+
+            if(!entities)
+            {
+                entities = m_system_manager->add_view_entities(signature, m_entity_manager->get_matching_entities(signature));
+            }
+
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                return View<Ts...>(entities, m_archetype_storage.get(), {m_component_manager->get_component_type<Ts>()...});
+            }
+
+            return View<Ts...>(entities, m_component_manager->get_component_array<std::remove_const_t<Ts>>()...);
+        }
+
+        //View over given entity sorted list, usually System::m_entities.
+        template<typename... Ts>
+        View<Ts...> view(const std::vector<EntityID>& a_entities)
+        {
+            static_assert(!(is_tag_v<Ts> || ...), "Tags have no data, System signatures filter by them");
+
+            if(m_backend == StorageBackend::ARCHETYPE)
+            {
+                return View<Ts...>(&a_entities, m_archetype_storage.get(), {m_component_manager->get_component_type<Ts>()...});
+            }
+
+            return View<Ts...>(&a_entities, m_component_manager->get_component_array<std::remove_const_t<Ts>>()...);
+        }
+
+        template<typename... Ts>
+        Signature make_signature()
+        {
+            Signature signature;
+            (signature.set(m_component_manager->get_component_type<Ts>(), true), ...);
+
+            return signature;
         }
 
         template<typename T>
         void register_component()
         {
             m_component_manager->register_component<T>();
+            m_archetype_storage->register_component<T>(m_component_manager->get_component_type<T>());
+
+            if constexpr(is_reflected_v<T> && !is_tag_v<T>)
+            {
+                m_reflection_registry.register_type<T>(m_component_manager->get_component_type<T>());
+            }
         }
 
         template<typename T>
@@ -90,6 +568,135 @@ namespace vis
             return m_system_manager->register_system<T>();
         }
 
+        //a_observer gets entities which gained or lost T, batched per sync point instead of per change.
+        //It stays registered for as long as the returned handle lives.
+        template<typename T>
+        ObserverHandle observe(ComponentObserver a_observer)
+        {
+            return ObserverHandle(weak_from_this(), m_component_manager->add_observer(m_component_manager->get_component_type<T>(), std::move(a_observer)));
+        }
+
+        void unobserve(ObserverId a_id)
+        {
+            m_component_manager->remove_observer(a_id);
+        }
+
+        //Sync point of component observers, update_systems runs it once commands are applied.
+        void dispatch_component_events()
+        {
+            m_component_manager->dispatch_events([this](EntityID a_id, ComponentType a_type) {
+                return m_entity_manager->is_alive(a_id) && m_entity_manager->get_signature(a_id).test(a_type);
+            });
+        }
+
+        template<typename T>
+        void set_system_access(const Signature& a_reads, const Signature& a_writes)
+        {
+            m_system_manager->set_access<T>(a_reads, a_writes);
+        }
+
+        //Runs on_update of every registered system, non conflicting ones in parallel on TPool.
+        //Commands recorded by systems are applied once all of them are done. Observers get changes made since the
+        //last update before systems run, so indices kept by observing systems are current, and the systems' own after.
+        void update_systems(float a_dt)
+        {
+            dispatch_component_events();
+            m_component_manager->sort_arrays();
+            m_system_manager->update_systems(a_dt, *m_entity_manager);
+            flush_commands();
+            dispatch_component_events();
+        }
+
+        //Buffer of the calling thread, structural changes recorded in it are applied by flush_commands.
+        CommandBuffer& get_command_buffer()
+        {
+            return m_command_queue.get_buffer();
+        }
+
+        //Sync point, must not run while any thread records commands. Pending entities are created first, then
+        //component changes are applied grouped by component type so every array is visited once, destroys go last.
+        //Signature of every touched entity is updated and reported to systems once.
+        void flush_commands()
+        {
+            std::vector<EntityID> created(m_command_queue.get_pending_count());
+            for(EntityID& id : created)
+            {
+                id = create_entity();
+            }
+
+            std::vector<Command> component_commands;
+            std::vector<EntityID> destroyed;
+
+            for(Command command : m_command_queue.collect_commands())
+            {
+                if(is_pending_entity(command.m_entity))
+                {
+                    std::uint32_t pending = get_entity_index(command.m_entity);
+                    command.m_entity = pending < created.size() ? created[pending] : NULL_ENTITY;
+                }
+
+                if(command.m_type == CommandType::DESTROY_ENTITY)
+                {
+                    destroyed.push_back(command.m_entity);
+                }
+                else
+                {
+                    component_commands.push_back(command);
+                }
+            }
+
+            std::stable_sort(component_commands.begin(), component_commands.end(), [](const Command& a_lhs, const Command& a_rhs) {
+                return a_lhs.m_component != a_rhs.m_component ? a_lhs.m_component < a_rhs.m_component : a_lhs.m_entity < a_rhs.m_entity;
+            });
+
+            std::vector<EntityID> touched;
+            for(const Command& command : component_commands)
+            {
+                if(m_entity_manager->is_alive(command.m_entity))
+                {
+                    touched.push_back(command.m_entity);
+                }
+            }
+
+            std::sort(touched.begin(), touched.end());
+            touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+            std::vector<SignatureChange> changes;
+            changes.reserve(touched.size());
+            for(EntityID id : touched)
+            {
+                Signature signature = m_entity_manager->get_signature(id);
+                changes.push_back(SignatureChange{ .m_entity = id, .m_old_signature = signature, .m_new_signature = signature });
+            }
+
+            for(const Command& command : component_commands)
+            {
+                if(m_entity_manager->is_alive(command.m_entity))
+                {
+                    apply_component_command(command);
+                }
+            }
+
+            for(SignatureChange& change : changes)
+            {
+                change.m_new_signature = m_entity_manager->get_signature(change.m_entity);
+            }
+
+            m_component_manager->record_changes(changes);
+            m_system_manager->on_entity_signatures_changed(changes);
+
+            std::sort(destroyed.begin(), destroyed.end());
+            destroyed.erase(std::unique(destroyed.begin(), destroyed.end()), destroyed.end());
+
+            for(EntityID id : destroyed)
+            {
+                destroy_entity(id);
+            }
+
+            m_system_manager->sync_memberships(*m_entity_manager);
+            m_command_queue.reset();
+        }
+
         template<typename T>
         ComponentType get_component_type()
         {
@@ -107,32 +714,199 @@ namespace vis
             return m_instance;
         }
 
-        Signature get_entity_signature(std::uint16_t a_id)
+        Signature get_entity_signature(EntityID a_id)
         {
             return m_entity_manager->get_signature(a_id);
         }
     private:
-        void create_managers()
+        //Applies storage and signature part of a single add or remove, systems are notified by the caller.
+        void apply_component_command(const Command& a_command)
         {
+            ComponentType type = a_command.m_component;
+            bool add = a_command.m_type == CommandType::ADD_COMPONENT;
+            IComponentArray* array = m_component_manager->get_component_array(type);
+
+            if(!array)
+            {
+                LOG_WARNING("Component type: {0} not registered before use!", type);
+                return;
+            }
+
+            if(m_backend == StorageBackend::ARCHETYPE && !m_component_manager->is_tag(type))
+            {
+                if(add)
+                {
+                    m_archetype_storage->add_component_erased(a_command.m_entity, type, a_command.m_payload);
+                }
+                else
+                {
+                    m_archetype_storage->remove_component(a_command.m_entity, type);
+                }
+            }
+            else
+            {
+                if(add)
+                {
+                    array->add_data_erased(a_command.m_entity, a_command.m_payload);
+                }
+                else
+                {
+                    array->remove_data(a_command.m_entity);
+                }
+            }
+
+            Signature signature = m_entity_manager->get_signature(a_command.m_entity);
+            signature.set(type, add);
+            m_entity_manager->set_signature(a_command.m_entity, signature);
+        }
+
+    private:
+        //Tags and, for the sparse set backend, components of create_entities.
+        template<typename T>
+        void add_bulk(const std::vector<EntityID>& a_ids, const T& a_component)
+        {
+            if constexpr(is_tag_v<T>)
+            {
+                TagArray* tags = m_component_manager->get_tag_array(m_component_manager->get_component_type<T>());
+                for(EntityID id : a_ids)
+                {
+                    tags->set(id);
+                }
+            }
+            else if(m_backend == StorageBackend::SPARSE_SET)
+            {
+                m_component_manager->get_component_array<T>()->add_data_bulk(a_ids.data(), a_ids.size(), a_component);
+            }
+        }
+
+        //Archetype storage never sees tags, they are dropped from the pack before it is handed over.
+        template<typename... Ts>
+        void add_to_archetypes(const std::vector<EntityID>& a_ids, const Ts&... a_components)
+        {
+            auto components = std::tuple_cat(select_component(a_components)...);
+
+            std::apply([this, &a_ids](const auto&... a_selected) {
+                if constexpr(sizeof...(a_selected) > 0)
+                {
+                    m_archetype_storage->add_entities<std::decay_t<decltype(a_selected)>...>(a_ids.data(), a_ids.size(),
+                        {m_component_manager->get_component_type<std::decay_t<decltype(a_selected)>>()...}, a_selected...);
+                }
+            }, components);
+        }
+
+        template<typename T>
+        static auto select_component(const T& a_component)
+        {
+            if constexpr(is_tag_v<T>)
+            {
+                return std::tuple<>();
+            }
+            else
+            {
+                return std::tuple<const T&>(a_component);
+            }
+        }
+
+        //Calls a_func(first word, words, count) with the AND of the TagArrays of Tags, TAG_QUERY_BLOCK words at a time.
+        template<typename... Tags, typename F>
+        void for_each_tag_block(F&& a_func)
+        {
+            static_assert(sizeof...(Tags) > 0 && (is_tag_v<Tags> && ...), "Only types deriving from Tag are tags");
+
+            std::array<const TagArray*, sizeof...(Tags)> arrays = { m_component_manager->get_tag_array(m_component_manager->get_component_type<Tags>())... };
+            std::array<const std::uint64_t*, sizeof...(Tags)> sets;
+            size_t word_count = SIZE_MAX;
+
+            for(const TagArray* array : arrays)
+            {
+                word_count = std::min(word_count, array->get_word_count());
+            }
+
+            std::uint64_t block[TAG_QUERY_BLOCK];
+            for(size_t first = 0; first < word_count; first += TAG_QUERY_BLOCK)
+            {
+                size_t count = std::min<size_t>(TAG_QUERY_BLOCK, word_count - first);
+                for(size_t i = 0; i < arrays.size(); i++)
+                {
+                    sets[i] = arrays[i]->get_words() + first;
+                }
+
+                and_tag_words(sets.data(), sets.size(), count, block);
+                a_func(first, block, count);
+            }
+        }
+
+        void create_managers(StorageBackend a_backend)
+        {
+            m_backend = a_backend;
+
             m_entity_manager = std::make_unique<EntityManager>();
             m_entity_manager->init();
 
             m_component_manager = std::make_unique<ComponentManager>();
             m_component_manager->init();
 
+            m_archetype_storage = std::make_unique<ArchetypeStorage>();
+
             m_system_manager = std::make_unique<SystemManager>();
             m_system_manager->init();
 
-            m_current_entity = MAX_ENTITIES;
+            m_current_entity = NULL_ENTITY;
         }
     private:
         std::unique_ptr<EntityManager>      m_entity_manager;
         std::unique_ptr<ComponentManager>   m_component_manager;
         std::unique_ptr<SystemManager>      m_system_manager;
+        std::unique_ptr<ArchetypeStorage>   m_archetype_storage;
+        StorageBackend                      m_backend;
+        CommandQueue                        m_command_queue;
+        ReflectionRegistry                  m_reflection_registry;
         static std::shared_ptr<MainManager> m_instance;
 
-        std::uint16_t                       m_current_entity;
+        EntityID                       m_current_entity;
     };
+
+    inline ObserverHandle::ObserverHandle(std::weak_ptr<MainManager> a_main_manager, ObserverId a_id)
+        : m_main_manager(std::move(a_main_manager)), m_id(a_id)
+    {
+    }
+
+    inline ObserverHandle::ObserverHandle(ObserverHandle&& a_other) noexcept
+        : m_main_manager(std::move(a_other.m_main_manager)), m_id(a_other.m_id)
+    {
+        a_other.m_id = INVALID_OBSERVER;
+    }
+
+    inline ObserverHandle& ObserverHandle::operator=(ObserverHandle&& a_other) noexcept
+    {
+        if(this != &a_other)
+        {
+            reset();
+            m_main_manager = std::move(a_other.m_main_manager);
+            m_id = a_other.m_id;
+            a_other.m_id = INVALID_OBSERVER;
+        }
+
+        return *this;
+    }
+
+    inline ObserverHandle::~ObserverHandle()
+    {
+        reset();
+    }
+
+    inline void ObserverHandle::reset()
+    {
+        auto main_manager = m_main_manager.lock();
+
+        if(main_manager && m_id != INVALID_OBSERVER)
+        {
+            main_manager->unobserve(m_id);
+        }
+
+        m_main_manager.reset();
+        m_id = INVALID_OBSERVER;
+    }
 }
 
 #endif //MAIN_MAINMANAGER_H
@@ -0,0 +1,20 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "Reflection.h"
+#include "Logger.h"
+
+namespace vis
+{
+    bool ReflectionRegistry::is_name_free(std::string_view a_name) const
+    {
+        if(find_type(a_name))
+        {
+            LOG_WARNING("Reflected name: {0} already used by another component!", a_name.data());
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,232 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_REFLECTION_H
+#define MAIN_REFLECTION_H
+
+#include <new>
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#include "Types.h"
+#include "glm/glm.hpp"
+
+namespace vis
+{
+    enum class FieldType : std::uint8_t
+    {
+        BOOL,
+        INT32,
+        UINT32,
+        FLOAT,
+        VEC2,
+        VEC3,
+        VEC4,
+        //EntityID referencing another entity, serializers remap it when entities get new ids on load.
+        ENTITY
+    };
+
+    inline size_t get_field_size(FieldType a_type)
+    {
+        switch(a_type)
+        {
+            case FieldType::BOOL:   return sizeof(bool);
+            case FieldType::INT32:  return sizeof(std::int32_t);
+            case FieldType::UINT32: return sizeof(std::uint32_t);
+            case FieldType::FLOAT:  return sizeof(float);
+            case FieldType::VEC2:   return 2 * sizeof(float);
+            case FieldType::VEC3:   return 3 * sizeof(float);
+            case FieldType::VEC4:   return 4 * sizeof(float);
+            case FieldType::ENTITY: return sizeof(EntityID);
+        }
+
+        return 0;
+    }
+
+    template<typename T>
+    struct FieldTypeOf;
+
+    template<> struct FieldTypeOf<bool>                 { static constexpr FieldType m_type = FieldType::BOOL; };
+    template<> struct FieldTypeOf<std::int32_t>         { static constexpr FieldType m_type = FieldType::INT32; };
+    template<> struct FieldTypeOf<std::uint32_t>        { static constexpr FieldType m_type = FieldType::UINT32; };
+    template<> struct FieldTypeOf<float>                { static constexpr FieldType m_type = FieldType::FLOAT; };
+    template<> struct FieldTypeOf<glm::vec2>            { static constexpr FieldType m_type = FieldType::VEC2; };
+    template<> struct FieldTypeOf<glm::vec3>            { static constexpr FieldType m_type = FieldType::VEC3; };
+    template<> struct FieldTypeOf<glm::vec4>            { static constexpr FieldType m_type = FieldType::VEC4; };
+    template<> struct FieldTypeOf<std::array<float, 2>> { static constexpr FieldType m_type = FieldType::VEC2; };
+    template<> struct FieldTypeOf<std::array<float, 3>> { static constexpr FieldType m_type = FieldType::VEC3; };
+    template<> struct FieldTypeOf<std::array<float, 4>> { static constexpr FieldType m_type = FieldType::VEC4; };
+
+    struct FieldInfo
+    {
+        std::string_view m_name;
+        FieldType        m_type;
+        std::uint32_t    m_offset;
+    };
+
+    //Everything serializers need to handle a component type without knowing it. Trivially copyable types
+    //are read and written as whole arrays, others field by field into default constructed components.
+    struct TypeInfo
+    {
+        std::string_view       m_name;
+        ComponentType          m_component_type;
+        std::uint32_t          m_size;
+        std::uint32_t          m_alignment;
+        bool                   m_trivially_copyable;
+        bool                   m_has_entity_fields;
+        std::vector<FieldInfo> m_fields;
+        void (*m_construct)(void* a_destination);
+        void (*m_destroy)(void* a_data);
+
+        const FieldInfo* find_field(std::string_view a_name) const
+        {
+            for(const FieldInfo& field : m_fields)
+            {
+                if(field.m_name == a_name)
+                {
+                    return &field;
+                }
+            }
+
+            return nullptr;
+        }
+    };
+
+    template<typename T>
+    class TypeBuilder
+    {
+    public:
+        explicit TypeBuilder(TypeInfo& a_info)
+        : m_info(a_info), m_object()
+        {
+
+        }
+
+        template<typename M>
+        TypeBuilder& field(std::string_view a_name, M T::* a_member)
+        {
+            return add(a_name, FieldTypeOf<M>::m_type, get_offset(a_member));
+        }
+
+        //Field holding a handle of another entity.
+        TypeBuilder& entity_field(std::string_view a_name, EntityID T::* a_member)
+        {
+            m_info.m_has_entity_fields = true;
+
+            return add(a_name, FieldType::ENTITY, get_offset(a_member));
+        }
+    private:
+        TypeBuilder& add(std::string_view a_name, FieldType a_type, std::uint32_t a_offset)
+        {
+            m_info.m_fields.push_back(FieldInfo{ .m_name = a_name, .m_type = a_type, .m_offset = a_offset });
+
+            return *this;
+        }
+
+        template<typename M>
+        std::uint32_t get_offset(M T::* a_member) const
+        {
+            const auto* base = reinterpret_cast<const std::byte*>(std::addressof(m_object));
+
+            return static_cast<std::uint32_t>(reinterpret_cast<const std::byte*>(std::addressof(m_object.*a_member)) - base);
+        }
+    private:
+        TypeInfo& m_info;
+
+        //Offsets are measured on a live object, member addresses inside raw storage would be undefined.
+        T         m_object;
+    };
+
+    //Specialize next to a component to make it serializable, m_name is the name it is saved under:
+    //
+    //  template<> struct Reflect<Color>
+    //  {
+    //      static constexpr std::string_view m_name = "Color";
+    //      static void reflect(TypeBuilder<Color>& a_builder) { a_builder.field("m_Color", &Color::m_color); }
+    //  };
+    //
+    //Components with private fields befriend their specialization.
+    template<typename T>
+    struct Reflect;
+
+    template<typename T, typename = void>
+    struct is_reflected : std::false_type {};
+
+    template<typename T>
+    struct is_reflected<T, std::void_t<decltype(Reflect<T>::m_name)>> : std::true_type {};
+
+    template<typename T>
+    inline constexpr bool is_reflected_v = is_reflected<T>::value;
+
+    //TypeInfo of every reflected component, indexed by component type.
+    class ReflectionRegistry
+    {
+    public:
+        template<typename T>
+        void register_type(ComponentType a_type)
+        {
+            if(a_type >= m_types.size())
+            {
+                m_types.resize(a_type + 1);
+            }
+
+            if(!is_name_free(Reflect<T>::m_name))
+            {
+                return;
+            }
+
+            TypeInfo& info = m_types[a_type];
+            info = TypeInfo{
+                .m_name = Reflect<T>::m_name,
+                .m_component_type = a_type,
+                .m_size = sizeof(T),
+                .m_alignment = alignof(T),
+                .m_trivially_copyable = std::is_trivially_copyable_v<T>,
+                .m_has_entity_fields = false,
+                .m_fields = {},
+                .m_construct = [](void* a_destination) { new (a_destination) T(); },
+                .m_destroy = [](void* a_data) { static_cast<T*>(a_data)->~T(); }
+            };
+
+            TypeBuilder<T> builder(info);
+            Reflect<T>::reflect(builder);
+        }
+
+        //nullptr for components without Reflect specialization.
+        const TypeInfo* get_type(ComponentType a_type) const
+        {
+            return a_type < m_types.size() && !m_types[a_type].m_name.empty() ? &m_types[a_type] : nullptr;
+        }
+
+        const TypeInfo* find_type(std::string_view a_name) const
+        {
+            for(const TypeInfo& info : m_types)
+            {
+                if(!info.m_name.empty() && info.m_name == a_name)
+                {
+                    return &info;
+                }
+            }
+
+            return nullptr;
+        }
+
+        size_t get_type_count() const
+        {
+            return m_types.size();
+        }
+    private:
+        //Warns when a_name is taken by another component.
+        bool is_name_free(std::string_view a_name) const;
+    private:
+        std::vector<TypeInfo> m_types;
+    };
+}
+
+#endif //MAIN_REFLECTION_H
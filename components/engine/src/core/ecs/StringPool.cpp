@@ -0,0 +1,75 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "StringPool.h"
+#include "Logger.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace vis
+{
+    StringPool::StringPool()
+    {
+        m_block_offset = 0;
+        m_block_size = 0;
+    }
+
+    StringId StringPool::intern(std::string_view a_string)
+    {
+        auto it = m_ids.find(a_string);
+
+        if(it != m_ids.end())
+        {
+            return it->second;
+        }
+
+        if(m_strings.size() >= INVALID_STRING_ID)
+        {
+            LOG_ERROR("Maximum interned strings count reached!");
+            return INVALID_STRING_ID;
+        }
+
+        char* data = allocate(a_string.size() + 1);
+        std::memcpy(data, a_string.data(), a_string.size());
+        data[a_string.size()] = '\0';
+
+        auto id = static_cast<StringId>(m_strings.size());
+        m_strings.emplace_back(data, a_string.size());
+        m_ids.insert({m_strings.back(), id});
+
+        return id;
+    }
+
+    std::string_view StringPool::get(StringId a_id) const
+    {
+        if(a_id >= m_strings.size())
+        {
+            LOG_ERROR("Trying to access non existing string: {0}", a_id);
+            return {};
+        }
+
+        return m_strings[a_id];
+    }
+
+    size_t StringPool::size() const
+    {
+        return m_strings.size();
+    }
+
+    char* StringPool::allocate(size_t a_size)
+    {
+        if(m_blocks.empty() || m_block_offset + a_size > m_block_size)
+        {
+            m_block_size = std::max<size_t>(STRING_POOL_BLOCK_SIZE, a_size);
+            m_blocks.push_back(std::make_unique<char[]>(m_block_size));
+            m_block_offset = 0;
+        }
+
+        char* data = m_blocks.back().get() + m_block_offset;
+        m_block_offset += a_size;
+
+        return data;
+    }
+}
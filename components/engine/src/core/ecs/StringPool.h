@@ -0,0 +1,47 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_STRINGPOOL_H
+#define MAIN_STRINGPOOL_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+#define INVALID_STRING_ID UINT32_MAX
+#define STRING_POOL_BLOCK_SIZE 16384
+
+namespace vis
+{
+    using StringId = std::uint32_t;
+
+    //Every distinct string is stored once, packed into large blocks and never moved or freed, so views
+    //returned by get stay valid for the lifetime of the pool. Stored strings are null terminated.
+    class StringPool
+    {
+    public:
+        StringPool();
+
+        StringPool(const StringPool& a_other) = delete;
+        StringPool& operator=(const StringPool& a_other) = delete;
+
+        //Returns id of a_string, storing it first if it wasn't interned yet.
+        StringId intern(std::string_view a_string);
+        std::string_view get(StringId a_id) const;
+
+        size_t size() const;
+    private:
+        char* allocate(size_t a_size);
+    private:
+        std::vector<std::unique_ptr<char[]>>           m_blocks;
+        size_t                                         m_block_offset;
+        size_t                                         m_block_size;
+        std::vector<std::string_view>                  m_strings;
+        std::unordered_map<std::string_view, StringId> m_ids;
+    };
+}
+
+#endif //MAIN_STRINGPOOL_H
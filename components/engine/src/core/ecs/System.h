@@ -5,7 +5,7 @@
 #ifndef MAIN_SYSTEM_H
 #define MAIN_SYSTEM_H
 
-#include <set>
+#include <vector>
 
 #include "Types.h"
 
@@ -14,7 +14,26 @@ namespace vis
     class System
     {
     public:
-        std::set<std::uint16_t> m_entities;
+        virtual ~System() = default;
+
+        //Called by SystemScheduler, possibly on a TPool thread at the same time as non conflicting systems.
+        virtual void on_update(float) {}
+
+        //Called after MainManager restored a world snapshot, caches derived from components must be dropped,
+        //restored components keep the ChangeTicks they had when the snapshot was taken.
+        virtual void on_world_restored() {}
+
+        //Entities matching system signature, kept sorted by id so views can walk it linearly.
+        std::vector<EntityID> m_entities;
+
+        //Components read and written in on_update, used by SystemScheduler to find conflicts.
+        Signature m_reads;
+        Signature m_writes;
+
+        //ChangeTick of the current and of the previous on_update, filter views with m_last_run_tick
+        //to visit only entities changed since the system last ran.
+        std::uint32_t m_run_tick = 0;
+        std::uint32_t m_last_run_tick = 0;
     };
 }
 
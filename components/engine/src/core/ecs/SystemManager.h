@@ -7,11 +7,19 @@
 
 #include <unordered_map>
 #include <memory>
+#include <vector>
+#include <algorithm>
 
 #include "Types.h"
 #include "System.h"
+#include "SystemScheduler.h"
+#include "TypeId.h"
+#include "ChangeTick.h"
 #include "Logger.h"
 #include "Entity.h"
+#include "EntityManager.h"
+
+#define INVALID_SYSTEM_INDEX -1
 
 namespace vis
 {
@@ -20,23 +28,42 @@ namespace vis
     public:
         void init()
         {
-            m_systems = std::unordered_map<const char*, std::shared_ptr<System>>();
-            m_signatures = std::unordered_map<const char*, Signature>();
+            m_systems = std::vector<std::shared_ptr<System>>();
+            m_signatures = std::vector<Signature>();
+            m_system_indices = std::vector<std::int32_t>();
+            m_view_entities = std::unordered_map<Signature, std::vector<EntityID>>();
+            m_memberships = std::vector<Membership>();
+            m_system_memberships = std::vector<std::uint32_t>();
+            m_component_memberships = std::vector<std::vector<std::uint32_t>>();
+            m_unfiltered_memberships = std::vector<std::uint32_t>();
+            m_visit_stamp = 0;
+            m_has_pending = false;
         }
 
         template<typename T>
         std::shared_ptr<T> register_system()
         {
-            const char* system_name = typeid(T).name();
+            std::uint32_t id = get_system_id<T>();
 
-            if(m_systems.find(system_name) != m_systems.end())
+            if(get_system_index(id) != INVALID_SYSTEM_INDEX)
             {
-                LOG_WARNING("Trying to register system: {0} more than once!", system_name);
+                LOG_WARNING("Trying to register system: {0} more than once!", typeid(T).name());
                 return nullptr;
             }
 
+            if(id >= m_system_indices.size())
+            {
+                m_system_indices.resize(id + 1, INVALID_SYSTEM_INDEX);
+            }
+
             auto system = std::make_shared<T>();
-            m_systems.insert({system_name, system});
+            m_system_indices[id] = static_cast<std::int32_t>(m_systems.size());
+            m_systems.push_back(system);
+            m_signatures.push_back(Signature());
+            m_system_memberships.push_back(static_cast<std::uint32_t>(m_memberships.size()));
+            m_memberships.push_back(Membership{ .m_signature = Signature(), .m_entities = &system->m_entities });
+            index_membership(m_system_memberships.back());
+            m_scheduler.invalidate();
 
             return system;
         }
@@ -44,47 +71,357 @@ namespace vis
         template<typename T>
         void set_signature(const Signature& a_signature)
         {
-            const char* system_name = typeid(T).name();
+            std::int32_t index = get_system_index(get_system_id<T>());
+
+            if(index == INVALID_SYSTEM_INDEX)
+            {
+                LOG_WARNING("Trying to set system signature before registering system: {0}", typeid(T).name());
+                return;
+            }
+
+            m_signatures[index] = a_signature;
+            m_memberships[m_system_memberships[index]].m_signature = a_signature;
+            rebuild_component_index();
+        }
+
+        template<typename T>
+        void set_access(const Signature& a_reads, const Signature& a_writes)
+        {
+            std::int32_t index = get_system_index(get_system_id<T>());
+
+            if(index == INVALID_SYSTEM_INDEX)
+            {
+                LOG_WARNING("Trying to set system access before registering system: {0}", typeid(T).name());
+                return;
+            }
+
+            auto& system = m_systems[index];
+            system->m_reads = a_reads;
+            system->m_writes = a_writes;
+            m_scheduler.invalidate();
+        }
+
+        //Every system gets its own tick, world tick is moved past all of them so writes made outside
+        //of systems are ordered after this update.
+        void update_systems(float a_dt, EntityManager& a_entity_manager)
+        {
+            sync_memberships(a_entity_manager);
+
+            std::uint32_t first_tick = ChangeTick::get_world() + 1;
+
+            for(size_t i = 0; i < m_systems.size(); i++)
+            {
+                m_systems[i]->m_last_run_tick = m_systems[i]->m_run_tick;
+                m_systems[i]->m_run_tick = first_tick + static_cast<std::uint32_t>(i);
+            }
+
+            ChangeTick::advance(static_cast<std::uint32_t>(m_systems.size()) + 1);
+            m_scheduler.run(m_systems, a_dt);
+        }
+
+        void on_world_restored()
+        {
+            for(auto& system : m_systems)
+            {
+                system->on_world_restored();
+            }
+        }
+
+        //Changes are only recorded, sync_memberships applies them so lists are not shifted once per entity.
+        //Only memberships requiring a component of a_signature can hold the entity.
+        void on_entity_destroyed(EntityID a_id, const Signature& a_signature)
+        {
+            for_each_membership(a_signature, [this, a_id, &a_signature](Membership& a_membership) {
+                if((a_signature & a_membership.m_signature) == a_membership.m_signature)
+                {
+                    record_erased(a_membership, a_id);
+                }
+            });
+        }
+
+        //Re-evaluates only systems and views requiring a component whose bit differs between the signatures.
+        //Memberships requiring nothing get every reported entity, sync_memberships drops the duplicates.
+        void on_entity_signature_changed(EntityID a_id, const Signature& a_old_signature, const Signature& a_new_signature)
+        {
+            for_each_membership(a_old_signature ^ a_new_signature, [&](Membership& a_membership) {
+                bool matched = (a_old_signature & a_membership.m_signature) == a_membership.m_signature;
+                bool matches = (a_new_signature & a_membership.m_signature) == a_membership.m_signature;
+
+                if(matches && (!matched || a_membership.m_signature.none()))
+                {
+                    record_inserted(a_membership, a_id);
+                }
+                else if(matched && !matches)
+                {
+                    record_erased(a_membership, a_id);
+                }
+            });
+        }
+
+        void on_entity_signatures_changed(const std::vector<SignatureChange>& a_changes)
+        {
+            for(const SignatureChange& change : a_changes)
+            {
+                on_entity_signature_changed(change.m_entity, change.m_old_signature, change.m_new_signature);
+            }
+        }
 
-            if(m_systems.find(system_name) == m_systems.end())
+        //Sync point, applies every recorded change with one erase pass and one merge per touched list.
+        //An entity both inserted and erased since the last sync ends up wherever its current signature puts it.
+        void sync_memberships(EntityManager& a_entity_manager)
+        {
+            if(!m_has_pending)
             {
-                LOG_WARNING("Trying to set system signature before registering system: {0}", system_name);
                 return;
             }
 
-            m_signatures.insert({system_name, a_signature});
+            for(Membership& membership : m_memberships)
+            {
+                if(membership.m_inserted.empty() && membership.m_erased.empty())
+                {
+                    continue;
+                }
+
+                sort_unique(membership.m_inserted);
+                sort_unique(membership.m_erased);
+                resolve_conflicts(membership, a_entity_manager);
+
+                erase_entities(*membership.m_entities, membership.m_erased);
+                merge_entities(*membership.m_entities, membership.m_inserted);
+                membership.m_inserted.clear();
+                membership.m_erased.clear();
+            }
+
+            m_has_pending = false;
+        }
+
+        //Batched on_entity_signature_changed for new entities, a_ids must be sorted.
+        void on_entities_created(const std::vector<EntityID>& a_ids, const Signature& a_signature)
+        {
+            for_each_membership(a_signature, [this, &a_ids, &a_signature](Membership& a_membership) {
+                if((a_signature & a_membership.m_signature) == a_membership.m_signature)
+                {
+                    a_membership.m_inserted.insert(a_membership.m_inserted.end(), a_ids.begin(), a_ids.end());
+                    m_has_pending = true;
+                }
+            });
+        }
+
+        //Returns cached list of entities matching a_signature or nullptr when no view asked for it yet.
+        //The list is current only after sync_memberships.
+        const std::vector<EntityID>* get_view_entities(const Signature& a_signature) const
+        {
+            auto it = m_view_entities.find(a_signature);
+
+            return it != m_view_entities.end() ? &it->second : nullptr;
+        }
+
+        const std::vector<EntityID>* add_view_entities(const Signature& a_signature, std::vector<EntityID> a_entities)
+        {
+            auto [it, inserted] = m_view_entities.insert({a_signature, std::move(a_entities)});
+
+            if(inserted)
+            {
+                //Map nodes never move, the pointer stays valid for the lifetime of the manager.
+                m_memberships.push_back(Membership{ .m_signature = a_signature, .m_entities = &it->second });
+                index_membership(static_cast<std::uint32_t>(m_memberships.size() - 1));
+            }
+
+            return &it->second;
+        }
+    private:
+        //Sorted entity list of a system or a cached view, kept in sync with the signature it requires.
+        struct Membership
+        {
+            Signature              m_signature;
+            std::vector<EntityID>* m_entities;
+            //Changes recorded since the last sync_memberships.
+            std::vector<EntityID>  m_inserted = {};
+            std::vector<EntityID>  m_erased = {};
+            std::uint32_t          m_visit_stamp = 0;
+        };
+
+        std::int32_t get_system_index(std::uint32_t a_id) const
+        {
+            return a_id < m_system_indices.size() ? m_system_indices[a_id] : INVALID_SYSTEM_INDEX;
+        }
+
+        //Calls a_func once for every membership requiring any component of a_components,
+        //memberships requiring nothing match every entity and are always visited.
+        template<typename F>
+        void for_each_membership(const Signature& a_components, F&& a_func)
+        {
+            std::uint32_t stamp = ++m_visit_stamp;
+
+            for(std::uint32_t membership : m_unfiltered_memberships)
+            {
+                a_func(m_memberships[membership]);
+            }
+
+            for(size_t bit = 0; bit < m_component_memberships.size(); bit++)
+            {
+                if(!a_components.test(bit))
+                {
+                    continue;
+                }
+
+                for(std::uint32_t membership : m_component_memberships[bit])
+                {
+                    if(m_memberships[membership].m_visit_stamp != stamp)
+                    {
+                        m_memberships[membership].m_visit_stamp = stamp;
+                        a_func(m_memberships[membership]);
+                    }
+                }
+            }
         }
 
-        void on_entity_destroyed(std::uint16_t a_id)
+        void index_membership(std::uint32_t a_membership)
         {
-            for(auto& system_pair : m_systems)
+            const Signature& signature = m_memberships[a_membership].m_signature;
+
+            if(signature.none())
             {
-                auto& system = system_pair.second;
-                system->m_entities.erase(a_id);
+                m_unfiltered_memberships.push_back(a_membership);
+                return;
+            }
+
+            for(size_t bit = 0; bit < MAX_COMPONENTS; bit++)
+            {
+                if(!signature.test(bit))
+                {
+                    continue;
+                }
+
+                if(bit >= m_component_memberships.size())
+                {
+                    m_component_memberships.resize(bit + 1);
+                }
+
+                m_component_memberships[bit].push_back(a_membership);
             }
         }
 
-        void on_entity_signature_changed(std::uint16_t a_id, const Signature& a_signature)
+        void rebuild_component_index()
         {
-            for(auto& system_pair : m_systems)
+            m_component_memberships.clear();
+            m_unfiltered_memberships.clear();
+
+            for(std::uint32_t membership = 0; membership < m_memberships.size(); membership++)
             {
-                const auto& name = system_pair.first;
-                auto& system = system_pair.second;
-                const auto& sys_signature = m_signatures[name];
+                index_membership(membership);
+            }
+        }
+
+        void record_inserted(Membership& a_membership, EntityID a_id)
+        {
+            a_membership.m_inserted.push_back(a_id);
+            m_has_pending = true;
+        }
+
+        void record_erased(Membership& a_membership, EntityID a_id)
+        {
+            a_membership.m_erased.push_back(a_id);
+            m_has_pending = true;
+        }
 
-                if((a_signature & sys_signature) == sys_signature)
+        //Entities found in both sorted lists are kept only in the one matching their current state.
+        static void resolve_conflicts(Membership& a_membership, EntityManager& a_entity_manager)
+        {
+            auto inserted = a_membership.m_inserted.begin();
+            auto erased = a_membership.m_erased.begin();
+            auto inserted_last = inserted;
+            auto erased_last = erased;
+
+            while(inserted != a_membership.m_inserted.end() || erased != a_membership.m_erased.end())
+            {
+                if(erased == a_membership.m_erased.end() || (inserted != a_membership.m_inserted.end() && *inserted < *erased))
+                {
+                    *inserted_last++ = *inserted++;
+                }
+                else if(inserted == a_membership.m_inserted.end() || *erased < *inserted)
                 {
-                    system->m_entities.insert(a_id);
+                    *erased_last++ = *erased++;
                 }
                 else
                 {
-                    system->m_entities.erase(a_id);
+                    bool member = a_entity_manager.is_alive(*inserted)
+                        && (a_entity_manager.get_signature(*inserted) & a_membership.m_signature) == a_membership.m_signature;
+
+                    if(member)
+                    {
+                        *inserted_last++ = *inserted;
+                    }
+                    else
+                    {
+                        *erased_last++ = *erased;
+                    }
+
+                    inserted++;
+                    erased++;
                 }
             }
+
+            a_membership.m_inserted.erase(inserted_last, a_membership.m_inserted.end());
+            a_membership.m_erased.erase(erased_last, a_membership.m_erased.end());
+        }
+
+        static void sort_unique(std::vector<EntityID>& a_ids)
+        {
+            std::sort(a_ids.begin(), a_ids.end());
+            a_ids.erase(std::unique(a_ids.begin(), a_ids.end()), a_ids.end());
+        }
+
+        //a_ids must be sorted, ids already in a_entities are not added again.
+        static void merge_entities(std::vector<EntityID>& a_entities, const std::vector<EntityID>& a_ids)
+        {
+            if(a_ids.empty())
+            {
+                return;
+            }
+
+            size_t middle = a_entities.size();
+
+            a_entities.insert(a_entities.end(), a_ids.begin(), a_ids.end());
+            std::inplace_merge(a_entities.begin(), a_entities.begin() + middle, a_entities.end());
+            a_entities.erase(std::unique(a_entities.begin(), a_entities.end()), a_entities.end());
+        }
+
+        //a_ids must be sorted, ids missing from a_entities are ignored.
+        static void erase_entities(std::vector<EntityID>& a_entities, const std::vector<EntityID>& a_ids)
+        {
+            if(a_ids.empty())
+            {
+                return;
+            }
+
+            auto removed = a_ids.begin();
+            auto last = std::remove_if(a_entities.begin(), a_entities.end(), [&removed, &a_ids](EntityID a_id) {
+                while(removed != a_ids.end() && *removed < a_id)
+                {
+                    removed++;
+                }
+
+                return removed != a_ids.end() && *removed == a_id;
+            });
+
+            a_entities.erase(last, a_entities.end());
         }
     private:
-        std::unordered_map<const char*, std::shared_ptr<System>> m_systems;
-        std::unordered_map<const char*, Signature> m_signatures;
+        //Systems and their signatures in registration order, m_system_indices maps system type id to that order.
+        std::vector<std::shared_ptr<System>> m_systems;
+        std::vector<Signature> m_signatures;
+        std::vector<std::int32_t> m_system_indices;
+        std::unordered_map<Signature, std::vector<EntityID>> m_view_entities;
+        SystemScheduler m_scheduler;
+
+        //Inverted index, m_component_memberships[bit] lists memberships whose signature has that bit set.
+        std::vector<Membership> m_memberships;
+        std::vector<std::uint32_t> m_system_memberships;
+        std::vector<std::vector<std::uint32_t>> m_component_memberships;
+        std::vector<std::uint32_t> m_unfiltered_memberships;
+        std::uint32_t m_visit_stamp;
+        bool m_has_pending;
     };
 }
 
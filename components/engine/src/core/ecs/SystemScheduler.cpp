@@ -0,0 +1,173 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "SystemScheduler.h"
+#include "TPool.h"
+#include "ChangeTick.h"
+
+namespace vis
+{
+    namespace
+    {
+        void update_system(System& a_system, float a_dt)
+        {
+            ChangeTick::Scope tick_scope(a_system.m_run_tick);
+            a_system.on_update(a_dt);
+        }
+
+        struct FrameState
+        {
+            const std::vector<std::shared_ptr<System>>* m_systems;
+            const std::vector<std::vector<size_t>>*     m_successors;
+            std::unique_ptr<std::atomic<int>[]>         m_remaining;
+            std::atomic<size_t>                         m_finished;
+            std::mutex                                  m_mutex;
+            std::condition_variable                     m_done;
+            float                                       m_dt;
+        };
+
+        void run_system(const std::shared_ptr<FrameState>& a_state, size_t a_index)
+        {
+            while(true)
+            {
+                update_system(*(*a_state->m_systems)[a_index], a_state->m_dt);
+
+                //First successor which becomes ready continues on this thread, the rest goes to the pool.
+                size_t next = SIZE_MAX;
+                for(size_t successor : (*a_state->m_successors)[a_index])
+                {
+                    if(a_state->m_remaining[successor].fetch_sub(1) != 1)
+                    {
+                        continue;
+                    }
+
+                    if(next == SIZE_MAX)
+                    {
+                        next = successor;
+                    }
+                    else if(!TPool::get_instance()->add_job([a_state, successor]() { run_system(a_state, successor); }))
+                    {
+                        run_system(a_state, successor);
+                    }
+                }
+
+                if(a_state->m_finished.fetch_add(1) + 1 == a_state->m_systems->size())
+                {
+                    std::lock_guard<std::mutex> lock(a_state->m_mutex);
+                    a_state->m_done.notify_all();
+                }
+
+                if(next == SIZE_MAX)
+                {
+                    return;
+                }
+
+                a_index = next;
+            }
+        }
+    }
+
+    void SystemScheduler::invalidate()
+    {
+        m_graph_valid = false;
+    }
+
+    void SystemScheduler::run(const std::vector<std::shared_ptr<System>>& a_systems, float a_dt)
+    {
+        if(a_systems.empty())
+        {
+            return;
+        }
+
+        TPool* pool = TPool::get_instance();
+        if(!pool || pool->get_thread_count() < 2 || a_systems.size() == 1)
+        {
+            run_serial(a_systems, a_dt);
+            return;
+        }
+
+        if(!m_graph_valid)
+        {
+            build_graph(a_systems);
+        }
+
+        auto state = std::make_shared<FrameState>();
+        state->m_systems    = &a_systems;
+        state->m_successors = &m_successors;
+        state->m_remaining  = std::make_unique<std::atomic<int>[]>(a_systems.size());
+        state->m_finished   = 0;
+        state->m_dt         = a_dt;
+
+        for(size_t i = 0; i < a_systems.size(); i++)
+        {
+            state->m_remaining[i] = m_dependencies_count[i];
+        }
+
+        for(size_t root : m_roots)
+        {
+            if(!pool->add_job([state, root]() { run_system(state, root); }))
+            {
+                run_system(state, root);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(state->m_mutex);
+        state->m_done.wait(lock, [&state, &a_systems]() { return state->m_finished == a_systems.size(); });
+    }
+
+    void SystemScheduler::build_graph(const std::vector<std::shared_ptr<System>>& a_systems)
+    {
+        m_successors = std::vector<std::vector<size_t>>(a_systems.size());
+        m_dependencies_count = std::vector<int>(a_systems.size(), 0);
+        m_roots.clear();
+
+        //Every earlier conflicting system becomes a dependency, so conflicting systems keep registration order.
+        for(size_t later = 0; later < a_systems.size(); later++)
+        {
+            for(size_t earlier = 0; earlier < later; earlier++)
+            {
+                if(conflicts(*a_systems[earlier], *a_systems[later]))
+                {
+                    m_successors[earlier].push_back(later);
+                    m_dependencies_count[later]++;
+                }
+            }
+
+            if(m_dependencies_count[later] == 0)
+            {
+                m_roots.push_back(later);
+            }
+        }
+
+        m_graph_valid = true;
+    }
+
+    void SystemScheduler::run_serial(const std::vector<std::shared_ptr<System>>& a_systems, float a_dt)
+    {
+        for(auto& system : a_systems)
+        {
+            update_system(*system, a_dt);
+        }
+    }
+
+    bool SystemScheduler::conflicts(const System& a_first, const System& a_second)
+    {
+        //System without declared access may touch anything.
+        if(a_first.m_reads.none() && a_first.m_writes.none())
+        {
+            return true;
+        }
+        if(a_second.m_reads.none() && a_second.m_writes.none())
+        {
+            return true;
+        }
+
+        return (a_first.m_writes & (a_second.m_reads | a_second.m_writes)).any()
+            || (a_second.m_writes & a_first.m_reads).any();
+    }
+}
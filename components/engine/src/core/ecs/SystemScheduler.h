@@ -0,0 +1,35 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_SYSTEMSCHEDULER_H
+#define MAIN_SYSTEMSCHEDULER_H
+
+#include <vector>
+#include <memory>
+
+#include "System.h"
+
+namespace vis
+{
+    //Runs on_update of all systems on TPool. Two systems conflict when one writes a component the other
+    //reads or writes, conflicting systems keep registration order, the rest run at the same time.
+    class SystemScheduler
+    {
+    public:
+        void invalidate();
+        void run(const std::vector<std::shared_ptr<System>>& a_systems, float a_dt);
+    private:
+        void build_graph(const std::vector<std::shared_ptr<System>>& a_systems);
+        void run_serial(const std::vector<std::shared_ptr<System>>& a_systems, float a_dt);
+
+        static bool conflicts(const System& a_first, const System& a_second);
+    private:
+        std::vector<std::vector<size_t>> m_successors;
+        std::vector<int>                 m_dependencies_count;
+        std::vector<size_t>              m_roots;
+        bool                             m_graph_valid = false;
+    };
+}
+
+#endif //MAIN_SYSTEMSCHEDULER_H
@@ -0,0 +1,183 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "TagArray.h"
+#include "math/Simd.h"
+
+#ifdef VIS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vis
+{
+    TagArray::TagArray()
+    {
+        m_words = std::make_shared<std::vector<std::uint64_t>>();
+        m_count = 0;
+    }
+
+    void TagArray::set(EntityID a_id)
+    {
+        std::uint32_t index = get_entity_index(a_id);
+        std::uint64_t bit = std::uint64_t(1) << (index % TAG_WORD_BITS);
+
+        if(test(a_id))
+        {
+            return;
+        }
+
+        std::vector<std::uint64_t>& words = get_words_for_write();
+        if(index / TAG_WORD_BITS >= words.size())
+        {
+            words.resize(index / TAG_WORD_BITS + 1, 0);
+        }
+
+        words[index / TAG_WORD_BITS] |= bit;
+        m_count++;
+    }
+
+    void TagArray::reset(EntityID a_id)
+    {
+        std::uint32_t index = get_entity_index(a_id);
+
+        if(!test(a_id))
+        {
+            return;
+        }
+
+        get_words_for_write()[index / TAG_WORD_BITS] &= ~(std::uint64_t(1) << (index % TAG_WORD_BITS));
+        m_count--;
+    }
+
+    bool TagArray::test(EntityID a_id) const
+    {
+        std::uint32_t index = get_entity_index(a_id);
+        const std::vector<std::uint64_t>& words = *m_words;
+
+        return index / TAG_WORD_BITS < words.size() && (words[index / TAG_WORD_BITS] >> (index % TAG_WORD_BITS)) & 1;
+    }
+
+    void TagArray::add_data_erased(EntityID a_id, void*)
+    {
+        set(a_id);
+    }
+
+    void TagArray::add_data_bulk_erased(const EntityID* a_ids, size_t a_count, void*)
+    {
+        for(size_t i = 0; i < a_count; i++)
+        {
+            set(a_ids[i]);
+        }
+    }
+
+    void TagArray::remove_data(EntityID a_id)
+    {
+        reset(a_id);
+    }
+
+    void TagArray::on_entity_destroyed(EntityID a_id)
+    {
+        reset(a_id);
+    }
+
+    void TagArray::sort()
+    {
+
+    }
+
+    void TagArray::copy_data(EntityID a_from, EntityID a_to)
+    {
+        if(test(a_from))
+        {
+            set(a_to);
+        }
+    }
+
+    std::unique_ptr<IComponentArray> TagArray::clone() const
+    {
+        auto snapshot = std::make_unique<TagArray>();
+        snapshot->m_words = m_words;
+        snapshot->m_count = m_count;
+
+        return snapshot;
+    }
+
+    void TagArray::restore(const IComponentArray* a_snapshot)
+    {
+        if(!a_snapshot)
+        {
+            m_words = std::make_shared<std::vector<std::uint64_t>>();
+            m_count = 0;
+            return;
+        }
+
+        const auto* snapshot = static_cast<const TagArray*>(a_snapshot);
+        m_words = snapshot->m_words;
+        m_count = snapshot->m_count;
+    }
+
+    size_t TagArray::size() const
+    {
+        return m_count;
+    }
+
+    const EntityID* TagArray::entities() const
+    {
+        return nullptr;
+    }
+
+    const void* TagArray::get_data_erased() const
+    {
+        return nullptr;
+    }
+
+    const std::uint64_t* TagArray::get_words() const
+    {
+        return m_words->data();
+    }
+
+    size_t TagArray::get_word_count() const
+    {
+        return m_words->size();
+    }
+
+    std::vector<std::uint64_t>& TagArray::get_words_for_write()
+    {
+        if(m_words.use_count() > 1)
+        {
+            m_words = std::make_shared<std::vector<std::uint64_t>>(*m_words);
+        }
+
+        return *m_words;
+    }
+
+    void and_tag_words(const std::uint64_t* const* a_sets, size_t a_set_count, size_t a_word_count, std::uint64_t* a_out)
+    {
+        size_t i = 0;
+
+#ifdef VIS_SIMD_SSE2
+        for(; i + 2 <= a_word_count; i += 2)
+        {
+            __m128i result = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_sets[0] + i));
+            for(size_t set = 1; set < a_set_count; set++)
+            {
+                result = _mm_and_si128(result, _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_sets[set] + i)));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(a_out + i), result);
+        }
+#endif
+
+        for(; i < a_word_count; i++)
+        {
+            std::uint64_t result = a_sets[0][i];
+            for(size_t set = 1; set < a_set_count; set++)
+            {
+                result &= a_sets[set][i];
+            }
+
+            a_out[i] = result;
+        }
+    }
+}
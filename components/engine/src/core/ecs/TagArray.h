@@ -0,0 +1,69 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_TAGARRAY_H
+#define MAIN_TAGARRAY_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+#include "Types.h"
+#include "ComponentArray.h"
+
+#define TAG_WORD_BITS 64
+
+namespace vis
+{
+    //Base of tag components, an empty type only becomes a tag by deriving from it.
+    struct Tag {};
+
+    //Tags carry no data and live in a TagArray instead of a ComponentArray, other empty types keep regular storage.
+    template<typename T>
+    inline constexpr bool is_tag_v = std::is_base_of_v<Tag, T>;
+
+    //Storage of a tag, one bit per entity index next to the bit in the entity signature. Adding or removing
+    //a tag touches no hash map or dense array, queries over tags AND whole words of several TagArrays.
+    //Bits are shared with snapshots and copied on write. Tags keep no dense arrays, entities and
+    //get_data_erased return nullptr.
+    class TagArray : public IComponentArray
+    {
+    public:
+        TagArray();
+
+        void set(EntityID a_id);
+        void reset(EntityID a_id);
+        bool test(EntityID a_id) const;
+
+        void add_data_erased(EntityID a_id, void* a_data) override;
+        void add_data_bulk_erased(const EntityID* a_ids, size_t a_count, void* a_data) override;
+        void remove_data(EntityID a_id) override;
+        void on_entity_destroyed(EntityID a_id) override;
+        void sort() override;
+
+        void copy_data(EntityID a_from, EntityID a_to) override;
+        std::unique_ptr<IComponentArray> clone() const override;
+        void restore(const IComponentArray* a_snapshot) override;
+
+        size_t size() const override;
+        const EntityID* entities() const override;
+        const void* get_data_erased() const override;
+
+        //Bit i % TAG_WORD_BITS of word i / TAG_WORD_BITS is set when entity with index i carries the tag.
+        const std::uint64_t* get_words() const;
+        size_t get_word_count() const;
+    private:
+        //Words for writing, copied first when a snapshot still shares them.
+        std::vector<std::uint64_t>& get_words_for_write();
+    private:
+        std::shared_ptr<std::vector<std::uint64_t>> m_words;
+        size_t m_count;
+    };
+
+    //a_out[i] = a_sets[0][i] & a_sets[1][i] & ..., two words at a time with SSE2 when available.
+    void and_tag_words(const std::uint64_t* const* a_sets, size_t a_set_count, size_t a_word_count, std::uint64_t* a_out);
+}
+
+#endif //MAIN_TAGARRAY_H
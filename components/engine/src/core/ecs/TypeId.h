@@ -0,0 +1,51 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_TYPEID_H
+#define MAIN_TYPEID_H
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace vis
+{
+    //Dense integer id per type, assigned on first use and unique within Family. Ids are stable for the
+    //lifetime of the process, so they can index flat arrays instead of hashing typeid(T).name().
+    template<typename Family>
+    class TypeId
+    {
+    public:
+        template<typename T>
+        static std::uint32_t get()
+        {
+            static const std::uint32_t id = m_next_id.fetch_add(1);
+            return id;
+        }
+
+        static std::uint32_t get_count()
+        {
+            return m_next_id.load();
+        }
+    private:
+        static inline std::atomic<std::uint32_t> m_next_id = 0;
+    };
+
+    struct ComponentFamily {};
+    struct SystemFamily {};
+
+    template<typename T>
+    inline std::uint32_t get_component_id()
+    {
+        return TypeId<ComponentFamily>::get<std::remove_cv_t<T>>();
+    }
+
+    template<typename T>
+    inline std::uint32_t get_system_id()
+    {
+        return TypeId<SystemFamily>::get<std::remove_cv_t<T>>();
+    }
+}
+
+#endif //MAIN_TYPEID_H
@@ -0,0 +1,346 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_VIEW_H
+#define MAIN_VIEW_H
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "Types.h"
+#include "TPool.h"
+#include "ComponentArray.h"
+#include "ArchetypeStorage.h"
+#include "ChangeTick.h"
+
+#define CACHE_LINE_SIZE 64
+#define DEFAULT_PARALLEL_GRAIN 1024
+#define NO_TICK_FILTER UINT32_MAX
+
+namespace vis
+{
+    //Query over entities owning all of Ts. Iterates a cached, entity sorted list of matching entities
+    //and walks the (also entity sorted) dense arrays of every component with its own cursor, so finding
+    //the components of the next entity is only a few pointer increments.
+    //Components requested as const T are read only, every other one visited is stamped as changed.
+    template<typename... Ts>
+    class View
+    {
+        static_assert(sizeof...(Ts) > 0, "View needs at least one component type");
+    public:
+        View(const std::vector<EntityID>* a_entities, ComponentArray<std::remove_const_t<Ts>>*... a_arrays)
+        : m_entities(a_entities), m_arrays(a_arrays...), m_archetype_storage(nullptr), m_types(), m_tick(ChangeTick::get())
+        {
+            m_added_since.fill(NO_TICK_FILTER);
+            m_changed_since.fill(NO_TICK_FILTER);
+        }
+
+        View(const std::vector<EntityID>* a_entities, ArchetypeStorage* a_storage, const std::array<ComponentType, sizeof...(Ts)>& a_types)
+        : m_entities(a_entities), m_arrays(), m_archetype_storage(a_storage), m_types(a_types), m_tick(ChangeTick::get())
+        {
+            m_added_since.fill(NO_TICK_FILTER);
+            m_changed_since.fill(NO_TICK_FILTER);
+        }
+
+        //Skips entities unless every Changed<T> / Added<T> in Fs was written / added after a_since_tick,
+        //usually System::m_last_run_tick. Archetype storage doesn't track changes, there filters pass everything.
+        template<typename... Fs>
+        View& filter(std::uint32_t a_since_tick)
+        {
+            (add_filter(Fs{}, a_since_tick), ...);
+
+            return *this;
+        }
+
+        //a_func is called as a_func(entity_id, Ts&...)
+        template<typename F>
+        void each(F&& a_func)
+        {
+            if(m_archetype_storage && !m_entities)
+            {
+                m_archetype_storage->each<Ts...>(m_types, a_func);
+                return;
+            }
+
+            each_in_range(0, size(), a_func);
+        }
+
+        //Same as each but matching entities are split into chunks processed on TPool, returns once all are done.
+        //a_func must only touch components of the entity it was called for.
+        template<typename F>
+        void parallel_each(F&& a_func, size_t a_grain = DEFAULT_PARALLEL_GRAIN)
+        {
+            parallel_run([&a_func](size_t, EntityID a_id, Ts&... a_components) {
+                a_func(a_id, a_components...);
+            }, a_grain);
+        }
+
+        //parallel_each with a private accumulator per participating thread. a_func is called as
+        //a_func(R& slot, entity_id, Ts&...), slots are merged into the result with a_combine(R& result, const R& slot).
+        //Slots start value initialized, so R() has to be neutral for both, a_init is folded in once as the result's start.
+        template<typename R, typename F, typename C>
+        R parallel_reduce(R a_init, F&& a_func, C&& a_combine, size_t a_grain = DEFAULT_PARALLEL_GRAIN)
+        {
+            struct alignas(CACHE_LINE_SIZE) Slot
+            {
+                R m_value;
+            };
+
+            TPool* pool = TPool::get_instance();
+            std::vector<Slot> slots((pool ? pool->get_thread_count() : 0) + 1, Slot{ R() });
+
+            parallel_run([&a_func, &slots](size_t a_slot, EntityID a_id, Ts&... a_components) {
+                a_func(slots[a_slot].m_value, a_id, a_components...);
+            }, a_grain);
+
+            R result = a_init;
+            for(const Slot& slot : slots)
+            {
+                a_combine(result, slot.m_value);
+            }
+
+            return result;
+        }
+
+        size_t size() const
+        {
+            return m_entities ? m_entities->size() : 0;
+        }
+    private:
+        template<typename T>
+        static constexpr size_t index_of()
+        {
+            constexpr bool matches[] = { std::is_same_v<std::remove_const_t<T>, std::remove_const_t<Ts>>... };
+            for(size_t i = 0; i < sizeof...(Ts); i++)
+            {
+                if(matches[i])
+                {
+                    return i;
+                }
+            }
+
+            return sizeof...(Ts);
+        }
+
+        template<typename T>
+        void add_filter(Changed<T>, std::uint32_t a_since_tick)
+        {
+            static_assert(index_of<T>() < sizeof...(Ts), "Filtered component must be part of the view");
+            m_changed_since[index_of<T>()] = a_since_tick;
+        }
+
+        template<typename T>
+        void add_filter(Added<T>, std::uint32_t a_since_tick)
+        {
+            static_assert(index_of<T>() < sizeof...(Ts), "Filtered component must be part of the view");
+            m_added_since[index_of<T>()] = a_since_tick;
+        }
+
+        template<typename F>
+        void parallel_run(F&& a_func, size_t a_grain)
+        {
+            TPool* pool = TPool::get_instance();
+
+            if(m_archetype_storage && !m_entities)
+            {
+                parallel_run_chunks(pool, a_func);
+                return;
+            }
+
+            sort_arrays(std::index_sequence_for<Ts...>());
+
+            //Chunk boundaries fall on whole cache lines of every component array, as long as they are walked in step.
+            size_t line_entries = std::max({ std::max<size_t>(CACHE_LINE_SIZE / sizeof(Ts), 1)... });
+            size_t grain = (std::max(a_grain, line_entries) + line_entries - 1) / line_entries * line_entries;
+
+            auto range_func = [this, &a_func](size_t a_begin, size_t a_end, size_t a_slot) {
+                each_in_range(a_begin, a_end, [&a_func, a_slot](EntityID a_id, Ts&... a_components) {
+                    a_func(a_slot, a_id, a_components...);
+                });
+            };
+
+            if(!pool)
+            {
+                range_func(0, size(), 0);
+                return;
+            }
+
+            pool->parallel_for(size(), grain, range_func);
+        }
+
+        template<typename F>
+        void parallel_run_chunks(TPool* a_pool, F& a_func)
+        {
+            struct ChunkRange
+            {
+                const EntityID* m_entities;
+                size_t               m_count;
+                std::tuple<Ts*...>   m_bases;
+            };
+
+            std::vector<ChunkRange> chunks;
+            m_archetype_storage->each_chunk<Ts...>(m_types, [&chunks](const EntityID* a_entities, size_t a_count, Ts*... a_bases) {
+                chunks.push_back(ChunkRange{ a_entities, a_count, std::tuple<Ts*...>(a_bases...) });
+            });
+
+            auto range_func = [&chunks, &a_func](size_t a_begin, size_t a_end, size_t a_slot) {
+                for(size_t chunk = a_begin; chunk < a_end; chunk++)
+                {
+                    const ChunkRange& range = chunks[chunk];
+                    for(size_t i = 0; i < range.m_count; i++)
+                    {
+                        std::apply([&](Ts*... a_bases) { a_func(a_slot, range.m_entities[i], a_bases[i]...); }, range.m_bases);
+                    }
+                }
+            };
+
+            if(!a_pool)
+            {
+                range_func(0, chunks.size(), 0);
+                return;
+            }
+
+            a_pool->parallel_for(chunks.size(), 1, range_func);
+        }
+
+        //Also gives every written array its own storage up front, chunks running on TPool would race on the copy.
+        template<size_t... Is>
+        void sort_arrays(std::index_sequence<Is...>)
+        {
+            if(!m_archetype_storage)
+            {
+                (std::get<Is>(m_arrays)->sort(), ...);
+                (get_stamped_ticks<Ts>(std::get<Is>(m_arrays)), ...);
+            }
+        }
+
+        //Arrays of const Ts are only read through their const interface, which never copies storage
+        //shared with a world snapshot.
+        template<typename T>
+        static auto get_array(ComponentArray<std::remove_const_t<T>>* a_array)
+        {
+            if constexpr(std::is_const_v<T>)
+            {
+                return static_cast<const ComponentArray<std::remove_const_t<T>>*>(a_array);
+            }
+            else
+            {
+                return a_array;
+            }
+        }
+
+        template<typename T>
+        static std::uint32_t* get_stamped_ticks(ComponentArray<std::remove_const_t<T>>* a_array)
+        {
+            if constexpr(std::is_const_v<T>)
+            {
+                return nullptr;
+            }
+            else
+            {
+                return a_array->changed_ticks();
+            }
+        }
+
+        template<typename F>
+        void each_in_range(size_t a_begin, size_t a_end, F&& a_func)
+        {
+            if(m_archetype_storage)
+            {
+                each_archetype_in_range(a_begin, a_end, a_func, std::index_sequence_for<Ts...>());
+                return;
+            }
+
+            each_sparse_in_range(a_begin, a_end, a_func, std::index_sequence_for<Ts...>());
+        }
+
+        template<typename F, size_t... Is>
+        void each_archetype_in_range(size_t a_begin, size_t a_end, F& a_func, std::index_sequence<Is...>)
+        {
+            for(size_t i = a_begin; i < a_end; i++)
+            {
+                EntityID id = (*m_entities)[i];
+
+                a_func(id, m_archetype_storage->get_component<Ts>(id, m_types[Is])...);
+            }
+        }
+
+        template<typename F, size_t... Is>
+        void each_sparse_in_range(size_t a_begin, size_t a_end, F& a_func, std::index_sequence<Is...>)
+        {
+            if(a_begin >= a_end)
+            {
+                return;
+            }
+
+            (std::get<Is>(m_arrays)->sort(), ...);
+
+            std::array<const EntityID*, sizeof...(Ts)> entities = { std::get<Is>(m_arrays)->entities()... };
+            std::array<size_t, sizeof...(Ts)> sizes = { std::get<Is>(m_arrays)->size()... };
+            std::array<const std::uint32_t*, sizeof...(Ts)> added = { std::get<Is>(m_arrays)->added_ticks()... };
+            std::array<const std::uint32_t*, sizeof...(Ts)> changed = { get_array<Ts>(std::get<Is>(m_arrays))->changed_ticks()... };
+            std::array<std::uint32_t*, sizeof...(Ts)> stamped = { get_stamped_ticks<Ts>(std::get<Is>(m_arrays))... };
+            std::tuple<Ts*...> data = { get_array<Ts>(std::get<Is>(m_arrays))->data()... };
+
+            //Cursors start at the first entity of the range, from there they only move forward.
+            EntityID first = (*m_entities)[a_begin];
+            std::array<size_t, sizeof...(Ts)> cursors;
+            for(size_t i = 0; i < sizeof...(Ts); i++)
+            {
+                cursors[i] = std::lower_bound(entities[i], entities[i] + sizes[i], first) - entities[i];
+            }
+
+            for(size_t entity = a_begin; entity < a_end; entity++)
+            {
+                EntityID id = (*m_entities)[entity];
+
+                bool found = true;
+                for(size_t i = 0; i < sizeof...(Ts); i++)
+                {
+                    while(cursors[i] < sizes[i] && entities[i][cursors[i]] < id)
+                    {
+                        cursors[i]++;
+                    }
+
+                    found = found && cursors[i] < sizes[i] && entities[i][cursors[i]] == id;
+                }
+
+                for(size_t i = 0; found && i < sizeof...(Ts); i++)
+                {
+                    found = (m_added_since[i] == NO_TICK_FILTER || added[i][cursors[i]] > m_added_since[i])
+                         && (m_changed_since[i] == NO_TICK_FILTER || changed[i][cursors[i]] > m_changed_since[i]);
+                }
+
+                if(!found)
+                {
+                    continue;
+                }
+
+                a_func(id, std::get<Is>(data)[cursors[Is]]...);
+
+                for(size_t i = 0; i < sizeof...(Ts); i++)
+                {
+                    if(stamped[i])
+                    {
+                        stamped[i][cursors[i]] = m_tick;
+                    }
+                }
+            }
+        }
+    private:
+        const std::vector<EntityID>*    m_entities;
+        std::tuple<ComponentArray<std::remove_const_t<Ts>>*...> m_arrays;
+        ArchetypeStorage*                    m_archetype_storage;
+        std::array<ComponentType, sizeof...(Ts)> m_types;
+        std::array<std::uint32_t, sizeof...(Ts)> m_added_since;
+        std::array<std::uint32_t, sizeof...(Ts)> m_changed_since;
+        std::uint32_t                        m_tick;
+    };
+}
+
+#endif //MAIN_VIEW_H
@@ -8,6 +8,8 @@
 #include <vector>
 #include <cstdint>
 
+#include "Types.h"
+#include "ecs/Reflection.h"
 #include "glm/glm.hpp"
 #include "glm/gtc/quaternion.hpp"
 #include "resource_loaders/resource_types/Mesh.h"
@@ -21,6 +23,12 @@ namespace vis
         glm::vec3 m_scale;
     };
 
+    //Makes Transform relative to the parent entity, NULL_ENTITY or a destroyed parent makes the entity a root.
+    struct Parent
+    {
+        EntityID m_parent;
+    };
+
     struct Color
     {
         glm::vec3 m_color;
@@ -55,6 +63,55 @@ namespace vis
         glm::vec3 m_color;
         unsigned int m_geometry_type;
     };
+
+    template<> struct Reflect<Transform>
+    {
+        static constexpr std::string_view m_name = "Transform";
+        static void reflect(TypeBuilder<Transform>& a_builder)
+        {
+            a_builder.field("m_Position", &Transform::m_position)
+                     .field("m_Rotation", &Transform::m_rotation)
+                     .field("m_Scale", &Transform::m_scale);
+        }
+    };
+
+    template<> struct Reflect<Parent>
+    {
+        static constexpr std::string_view m_name = "Parent";
+        static void reflect(TypeBuilder<Parent>& a_builder)
+        {
+            a_builder.entity_field("m_Parent", &Parent::m_parent);
+        }
+    };
+
+    template<> struct Reflect<Color>
+    {
+        static constexpr std::string_view m_name = "Color";
+        static void reflect(TypeBuilder<Color>& a_builder)
+        {
+            a_builder.field("m_Color", &Color::m_color);
+        }
+    };
+
+    template<> struct Reflect<RigidBody>
+    {
+        static constexpr std::string_view m_name = "RigidBody";
+        static void reflect(TypeBuilder<RigidBody>& a_builder)
+        {
+            a_builder.field("m_VelX", &RigidBody::vel_x)
+                     .field("m_VelY", &RigidBody::vel_y)
+                     .field("m_VelZ", &RigidBody::vel_z);
+        }
+    };
+
+    template<> struct Reflect<MeshComponent>
+    {
+        static constexpr std::string_view m_name = "Mesh";
+        static void reflect(TypeBuilder<MeshComponent>& a_builder)
+        {
+            a_builder.field("m_ID", &MeshComponent::m_id);
+        }
+    };
 }
 
 #endif //MAIN_BASICCOMPONENTS_H
@@ -7,6 +7,8 @@
 
 #include <array>
 
+#include "ecs/Reflection.h"
+
 namespace vis
 {
     class SceneCamera
@@ -24,6 +26,8 @@ namespace vis
         float& get_z_far();
         float& get_fov();
     private:
+        friend struct Reflect<SceneCamera>;
+
         bool m_use_skybox;
         bool m_perspective_view;
         float m_FOV;
@@ -31,6 +35,20 @@ namespace vis
         float m_far;
         std::array<float, 3> m_clear_color;
     };
+
+    template<> struct Reflect<SceneCamera>
+    {
+        static constexpr std::string_view m_name = "SceneCamera";
+        static void reflect(TypeBuilder<SceneCamera>& a_builder)
+        {
+            a_builder.field("m_UseSkybox", &SceneCamera::m_use_skybox)
+                     .field("m_PerspectiveView", &SceneCamera::m_perspective_view)
+                     .field("m_FOV", &SceneCamera::m_FOV)
+                     .field("m_zNear", &SceneCamera::m_near)
+                     .field("m_zFar", &SceneCamera::m_far)
+                     .field("m_ClearColor", &SceneCamera::m_clear_color);
+        }
+    };
 }
 
 #endif //MAIN_SCENECAMERA_H
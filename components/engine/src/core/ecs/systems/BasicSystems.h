@@ -6,72 +6,215 @@
 #define MAIN_BASICSYSTEMS_H
 
 #include <vector>
+#include <numeric>
 
 #include "ecs/System.h"
 #include "ecs/MainManager.h"
+#include "ecs/systems/TransformSystem.h"
 #include "ecs/components/BasicComponents.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include "managers/MeshManager.h"
+#include "math/Frustum.h"
+#include "physics/BodyIntegrator.h"
 #include "Renderer.h"
 
 namespace vis
 {
+    //Moves RigidBody entities through a BodyIntegrator, only bodies awake in it cost anything per update besides
+    //the change checks. Bodies are woken by gaining the components or by writes to their Transform or RigidBody
+    //from outside the system, e.g. the editor or gameplay code. Transform and RigidBody have to be registered first.
     class PhysicsSystem : public System
     {
     public:
-        void on_update(float a_dt)
+        PhysicsSystem()
         {
-            for (const std::uint16_t &id : m_entities)
+            auto main_manager = MainManager::get_instance();
+            auto on_events = [this](const ComponentEvents& a_events) {
+                on_body_events(a_events);
+            };
+
+            m_observers = { main_manager->observe<Transform>(on_events), main_manager->observe<RigidBody>(on_events) };
+        }
+
+        void on_update(float a_dt) override
+        {
+            auto main_manager = MainManager::get_instance();
+
+            if(m_rebuild)
+            {
+                m_rebuild = false;
+                m_integrator.clear();
+
+                main_manager->view<const RigidBody, const Transform>(m_entities).each([this](EntityID a_id, const RigidBody& a_rigid_body, const Transform& a_transform) {
+                    m_integrator.update(a_id, a_transform.m_position, glm::vec3(a_rigid_body.vel_x, a_rigid_body.vel_y, a_rigid_body.vel_z));
+                });
+            }
+            else
             {
-                auto &rigid_body = MainManager::get_instance()->get_component<RigidBody>(id);
-                auto &transf = MainManager::get_instance()->get_component<Transform>(id);
+                //Writes of this system are stamped with its previous run tick, so only outside writes pass. Single
+                //component views keep the walk over sleeping bodies to one array each.
+                m_changed.clear();
+                main_manager->view<const RigidBody>(m_entities).filter<Changed<RigidBody>>(m_last_run_tick).each([this](EntityID a_id, const RigidBody&) {
+                    m_changed.push_back(a_id);
+                });
+                main_manager->view<const Transform>(m_entities).filter<Changed<Transform>>(m_last_run_tick).each([this](EntityID a_id, const Transform&) {
+                    m_changed.push_back(a_id);
+                });
 
-                transf.m_position.x += rigid_body.vel_x * a_dt;
-                transf.m_position.y += rigid_body.vel_y * a_dt;
-                transf.m_position.z += rigid_body.vel_z * a_dt;
+                for(EntityID id : m_changed)
+                {
+                    load_body(id);
+                }
             }
+
+            m_integrator.integrate(a_dt);
+
+            m_integrator.for_each_integrated([&main_manager](EntityID a_id, const glm::vec3& a_position, const glm::vec3& a_velocity) {
+                main_manager->get_component<Transform>(a_id).m_position = a_position;
+                main_manager->get_component<RigidBody>(a_id) = RigidBody{ a_velocity.x, a_velocity.y, a_velocity.z };
+            });
         }
+
+        //Restored components carry old ticks, change filters would miss them.
+        void on_world_restored() override
+        {
+            m_rebuild = true;
+        }
+
+        BodyIntegrator& get_integrator()
+        {
+            return m_integrator;
+        }
+    private:
+        void on_body_events(const ComponentEvents& a_events)
+        {
+            if(m_rebuild)
+            {
+                return;
+            }
+
+            for(EntityID id : a_events.m_removed)
+            {
+                m_integrator.remove(id);
+            }
+
+            auto main_manager = MainManager::get_instance();
+            Signature body_signature = main_manager->make_signature<Transform, RigidBody>();
+
+            for(EntityID id : a_events.m_added)
+            {
+                if((main_manager->get_entity_signature(id) & body_signature) == body_signature)
+                {
+                    load_body(id);
+                }
+            }
+        }
+
+        void load_body(EntityID a_id)
+        {
+            auto main_manager = MainManager::get_instance();
+            const RigidBody& rigid_body = main_manager->get_component<RigidBody>(a_id);
+
+            m_integrator.update(a_id, main_manager->get_component<Transform>(a_id).m_position, glm::vec3(rigid_body.vel_x, rigid_body.vel_y, rigid_body.vel_z));
+        }
+    private:
+        BodyIntegrator                m_integrator;
+        std::vector<EntityID>         m_changed;
+        std::array<ObserverHandle, 2> m_observers;
+        bool                          m_rebuild = true;
     };
 
     class RendererSystem : public System
     {
     public:
-        void on_render()
+        //Entities whose mesh bounds are outside the camera frustum are dropped before any draw data is built.
+        //a_alpha blends world matrices between the last two updates, see TransformSystem::get_interpolated_world_matrix.
+        void on_render(float a_alpha = 1.0f)
         {
+            gather_drawables(a_alpha);
+
+            Camera* camera = Renderer::get_camera();
+            m_visible.resize(m_drawables.size());
+
+            if(camera)
+            {
+                m_drawn_count = cull_bounds(make_frustum(camera->get_projection() * camera->get_view()), m_bounds, m_visible.data());
+            }
+            else
+            {
+                std::iota(m_visible.begin(), m_visible.end(), 0);
+                m_drawn_count = m_drawables.size();
+            }
+
+            m_culled_count = m_drawables.size() - m_drawn_count;
+
             Renderer::begin();
 
-            auto it = m_entities.begin();
-            while (it != m_entities.end())
+            for(size_t i = 0; i < m_drawn_count; i++)
             {
-                auto &transform = MainManager::get_instance()->get_component<Transform>(*it);
-                auto &color = MainManager::get_instance()->get_component<Color>(*it);
-                std::uint16_t mesh_id = MainManager::get_instance()->get_component<MeshComponent>(*it).m_id;
-                auto mesh = MeshManager::get()->get_mesh(mesh_id);
-
-                glm::mat4 transform_mat = glm::mat4(1.0f);
-                transform_mat = glm::translate(transform_mat, transform.m_position);
-
-                transform_mat = glm::rotate(transform_mat, glm::radians(transform.m_rotation.x),
-                                            glm::vec3(1.0f, 0.0f, 0.0f));
-                transform_mat = glm::rotate(transform_mat, glm::radians(transform.m_rotation.y),
-                                            glm::vec3(0.0f, 1.0f, 0.0f));
-                transform_mat = glm::rotate(transform_mat, glm::radians(transform.m_rotation.z),
-                                            glm::vec3(0.0f, 0.0f, 1.0f));
-
-                transform_mat = glm::scale(transform_mat, transform.m_scale);
-
-                MeshRender mesh_render = MeshRender{.m_vertices = mesh->get_vertices(),
-                        .m_indices = mesh->get_indices(),
-                        .m_model = transform_mat,
-                        .m_color = color.m_color,
-                        .m_geometry_type = mesh->get_geometry_type()};
-                Renderer::render(mesh_render);
+                const Drawable& drawable = m_drawables[m_visible[i]];
 
-                it++;
+                MeshRender mesh_render = MeshRender{.m_vertices = drawable.m_mesh->get_vertices(),
+                        .m_indices = drawable.m_mesh->get_indices(),
+                        .m_model = drawable.m_model,
+                        .m_color = drawable.m_color,
+                        .m_geometry_type = drawable.m_mesh->get_geometry_type()};
+                Renderer::render(mesh_render);
             }
 
             Renderer::end();
         }
+
+        //World matrices come from a_system, entities it doesn't know yet are drawn with their local transform.
+        void set_transform_system(const std::shared_ptr<TransformSystem>& a_system)
+        {
+            m_transform_system = a_system;
+        }
+
+        //Counts of the last on_render.
+        size_t get_drawn_count() const
+        {
+            return m_drawn_count;
+        }
+
+        size_t get_culled_count() const
+        {
+            return m_culled_count;
+        }
+    private:
+        struct Drawable
+        {
+            Mesh*     m_mesh;
+            glm::mat4 m_model;
+            glm::vec3 m_color;
+        };
+
+        void gather_drawables(float a_alpha)
+        {
+            m_drawables.clear();
+            m_bounds.clear();
+
+            MainManager::get_instance()->view<const Transform, const Color, const MeshComponent>(m_entities).each([this, a_alpha](EntityID a_id, const Transform& transform, const Color& color, const MeshComponent& mesh_component) {
+                Mesh* mesh = MeshManager::get()->get_mesh(mesh_component.m_id);
+                if(!mesh)
+                {
+                    return;
+                }
+
+                bool has_world = m_transform_system && m_transform_system->has_world_matrix(a_id);
+                glm::mat4 model = has_world ? m_transform_system->get_interpolated_world_matrix(a_id, a_alpha) : TransformSystem::compose_local(transform);
+
+                m_bounds.push(mesh->get_aabb(), mesh->get_bounding_sphere(), model);
+                m_drawables.push_back(Drawable{ .m_mesh = mesh, .m_model = model, .m_color = color.m_color });
+            });
+        }
+    private:
+        std::shared_ptr<TransformSystem> m_transform_system;
+        std::vector<Drawable>            m_drawables;
+        CullBounds                       m_bounds;
+        std::vector<std::uint32_t>       m_visible;
+        size_t                           m_drawn_count = 0;
+        size_t                           m_culled_count = 0;
     };
 }
 
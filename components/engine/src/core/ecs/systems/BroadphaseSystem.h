@@ -0,0 +1,105 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_BROADPHASESYSTEM_H
+#define MAIN_BROADPHASESYSTEM_H
+
+#include "ecs/System.h"
+#include "ecs/MainManager.h"
+#include "ecs/components/BasicComponents.h"
+#include "physics/SweepAndPrune.h"
+
+namespace vis
+{
+    //Pairs of RigidBody entities whose boxes overlap, for a narrowphase to confirm. Boxes of entities gaining or
+    //losing either component come through component observers, moved ones through a Changed<Transform> filter.
+    //Transform and RigidBody have to be registered before the system, which has to run after systems moving bodies.
+    class BroadphaseSystem : public System
+    {
+    public:
+        BroadphaseSystem()
+        {
+            auto main_manager = MainManager::get_instance();
+            auto on_events = [this](const ComponentEvents& a_events) {
+                on_body_events(a_events);
+            };
+
+            m_observers = { main_manager->observe<Transform>(on_events), main_manager->observe<RigidBody>(on_events) };
+        }
+
+        void on_update(float) override
+        {
+            auto main_manager = MainManager::get_instance();
+
+            if(m_rebuild)
+            {
+                m_rebuild = false;
+                m_broadphase.clear();
+
+                main_manager->view<const Transform>(m_entities).each([this](EntityID a_id, const Transform& a_transform) {
+                    m_broadphase.update(a_id, make_body_box(a_transform));
+                });
+            }
+            else
+            {
+                main_manager->view<const Transform>(m_entities).filter<Changed<Transform>>(m_last_run_tick).each([this](EntityID a_id, const Transform& a_transform) {
+                    m_broadphase.update(a_id, make_body_box(a_transform));
+                });
+            }
+
+            m_broadphase.update_pairs();
+        }
+
+        //Restored transforms carry old ticks, change filters would miss them.
+        void on_world_restored() override
+        {
+            m_rebuild = true;
+        }
+
+        //Pairs as of the last update.
+        const std::vector<BroadphasePair>& get_pairs() const
+        {
+            return m_broadphase.get_pairs();
+        }
+
+        //Bodies have no shape of their own yet, they are unit cubes scaled by Transform::m_scale like the mesh
+        //primitives. The box bounds the sphere around such cube, so it holds under any rotation.
+        static AABB make_body_box(const Transform& a_transform)
+        {
+            glm::vec3 half_extent = glm::vec3(0.5f * glm::length(a_transform.m_scale));
+
+            return AABB{ a_transform.m_position - half_extent, a_transform.m_position + half_extent };
+        }
+    private:
+        void on_body_events(const ComponentEvents& a_events)
+        {
+            if(m_rebuild)
+            {
+                return;
+            }
+
+            for(EntityID id : a_events.m_removed)
+            {
+                m_broadphase.remove(id);
+            }
+
+            auto main_manager = MainManager::get_instance();
+            Signature body_signature = main_manager->make_signature<Transform, RigidBody>();
+
+            for(EntityID id : a_events.m_added)
+            {
+                if((main_manager->get_entity_signature(id) & body_signature) == body_signature)
+                {
+                    m_broadphase.update(id, make_body_box(main_manager->get_component<Transform>(id)));
+                }
+            }
+        }
+    private:
+        SweepAndPrune                 m_broadphase;
+        std::array<ObserverHandle, 2> m_observers;
+        bool                          m_rebuild = true;
+    };
+}
+
+#endif //MAIN_BROADPHASESYSTEM_H
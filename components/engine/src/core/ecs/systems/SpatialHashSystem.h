@@ -0,0 +1,94 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_SPATIALHASHSYSTEM_H
+#define MAIN_SPATIALHASHSYSTEM_H
+
+#include "ecs/System.h"
+#include "ecs/MainManager.h"
+#include "ecs/components/BasicComponents.h"
+#include "spatial/SpatialHashGrid.h"
+
+namespace vis
+{
+    //Keeps a SpatialHashGrid of Transform::m_position of its entities. Entities gaining or losing Transform come
+    //through a component observer, moved ones through a Changed<Transform> filter in on_update, so an update only
+    //touches what changed since the last one. Transform has to be registered before the system.
+    //The grid is rewritten in on_update, systems querying it from their own on_update must be ordered after this
+    //one by SystemScheduler: registered later and declared as writing a component it reads.
+    class SpatialHashSystem : public System
+    {
+    public:
+        SpatialHashSystem()
+        {
+            m_observer = MainManager::get_instance()->observe<Transform>([this](const ComponentEvents& a_events) {
+                on_transform_events(a_events);
+            });
+        }
+
+        void on_update(float) override
+        {
+            auto main_manager = MainManager::get_instance();
+
+            if(m_rebuild)
+            {
+                m_rebuild = false;
+                m_grid.clear();
+
+                main_manager->view<const Transform>(m_entities).each([this](EntityID a_id, const Transform& a_transform) {
+                    m_grid.update(a_id, a_transform.m_position);
+                });
+
+                return;
+            }
+
+            main_manager->view<const Transform>(m_entities).filter<Changed<Transform>>(m_last_run_tick).each([this](EntityID a_id, const Transform& a_transform) {
+                m_grid.update(a_id, a_transform.m_position);
+            });
+        }
+
+        //Restored transforms carry old ticks, change filters would miss them.
+        void on_world_restored() override
+        {
+            m_rebuild = true;
+        }
+
+        //Positions as of the last update.
+        const SpatialHashGrid& get_grid() const
+        {
+            return m_grid;
+        }
+
+        void set_cell_size(float a_cell_size)
+        {
+            m_grid.set_cell_size(a_cell_size);
+            m_rebuild = true;
+        }
+    private:
+        void on_transform_events(const ComponentEvents& a_events)
+        {
+            if(m_rebuild)
+            {
+                return;
+            }
+
+            for(EntityID id : a_events.m_removed)
+            {
+                m_grid.remove(id);
+            }
+
+            auto main_manager = MainManager::get_instance();
+            for(EntityID id : a_events.m_added)
+            {
+                m_grid.update(id, main_manager->get_component<Transform>(id).m_position);
+            }
+        }
+    private:
+        SpatialHashGrid m_grid;
+        ObserverHandle  m_observer;
+        bool            m_rebuild = true;
+    };
+}
+
+#endif //MAIN_SPATIALHASHSYSTEM_H
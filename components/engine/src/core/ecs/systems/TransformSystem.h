@@ -0,0 +1,402 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_TRANSFORMSYSTEM_H
+#define MAIN_TRANSFORMSYSTEM_H
+
+#include <vector>
+#include <algorithm>
+
+#include "ecs/System.h"
+#include "ecs/MainManager.h"
+#include "ecs/components/BasicComponents.h"
+#include "math/TransformKernel.h"
+#include "glm/gtc/quaternion.hpp"
+#include "TPool.h"
+#include "Logger.h"
+
+#define INVALID_HIERARCHY_SLOT UINT32_MAX
+#define HIERARCHY_BLOCKS_GRAIN 64
+
+namespace vis
+{
+    //Keeps local and world matrix of every entity with Transform. Entities are laid out in slots, one block per
+    //root holding its whole tree in breadth first order, so parents always precede children and a block can be
+    //propagated front to back. Only blocks with a changed Transform are visited, in parallel on TPool.
+    //World matrices of the update before the last one are kept too, so rendering can blend between the two.
+    class TransformSystem : public System
+    {
+    public:
+        void on_update(float) override
+        {
+            auto main_manager = MainManager::get_instance();
+            catch_up_previous_world();
+
+            bool rebuild = m_world_restored
+                        || m_slots.size() != m_entities.size()
+                        || m_parent_count != main_manager->get_component_count<Parent>();
+            m_world_restored = false;
+
+            main_manager->view<const Parent>().filter<Changed<Parent>>(m_last_run_tick).each([&rebuild](EntityID, const Parent&) {
+                rebuild = true;
+            });
+
+            if(!rebuild)
+            {
+                m_batch_slots.clear();
+                m_batch_transforms.clear();
+
+                //New members always show up here, adding Transform stamps it as changed.
+                main_manager->view<const Transform>(m_entities).filter<Changed<Transform>>(m_last_run_tick).each([this, &rebuild](EntityID a_id, const Transform& a_transform) {
+                    std::uint32_t slot = get_slot(a_id);
+
+                    if(slot == INVALID_HIERARCHY_SLOT)
+                    {
+                        rebuild = true;
+                        return;
+                    }
+
+                    m_batch_slots.push_back(slot);
+                    m_batch_transforms.push_back(a_transform);
+                });
+
+                if(!rebuild)
+                {
+                    update_changed_locals();
+                }
+            }
+
+            if(rebuild)
+            {
+                rebuild_layout();
+            }
+
+            propagate();
+
+            //Slots moved around, nothing to blend from.
+            if(rebuild)
+            {
+                m_previous_world = m_world;
+                m_moved_blocks.clear();
+            }
+        }
+
+        //Restored transforms carry old ticks, change filters would miss them.
+        void on_world_restored() override
+        {
+            m_world_restored = true;
+        }
+
+        //False for entities which got Transform after the last update.
+        bool has_world_matrix(EntityID a_id) const
+        {
+            return get_slot(a_id) != INVALID_HIERARCHY_SLOT;
+        }
+
+        //World matrix of a_id as of the last update, identity for entities without one.
+        const glm::mat4& get_world_matrix(EntityID a_id) const
+        {
+            std::uint32_t slot = get_slot(a_id);
+
+            return slot != INVALID_HIERARCHY_SLOT ? m_world[slot] : m_identity;
+        }
+
+        //World matrix blended from the one of the update before the last one at a_alpha 0 to the current one at 1.
+        //Translation and scale are blended linearly and rotation is slerped, so spinning bodies keep their shape.
+        glm::mat4 get_interpolated_world_matrix(EntityID a_id, float a_alpha) const
+        {
+            std::uint32_t slot = get_slot(a_id);
+
+            if(slot == INVALID_HIERARCHY_SLOT)
+            {
+                return m_identity;
+            }
+
+            const glm::mat4& previous = m_previous_world[slot];
+            const glm::mat4& current = m_world[slot];
+
+            if(previous == current)
+            {
+                return current;
+            }
+
+            WorldPose from;
+            WorldPose to;
+            if(!decompose_world(previous, from) || !decompose_world(current, to))
+            {
+                return previous + (current - previous) * a_alpha;
+            }
+
+            glm::mat4 world = glm::mat4_cast(glm::slerp(from.m_rotation, to.m_rotation, a_alpha));
+            glm::vec3 scale = glm::mix(from.m_scale, to.m_scale, a_alpha);
+
+            world[0] *= scale.x;
+            world[1] *= scale.y;
+            world[2] *= scale.z;
+            world[3] = glm::vec4(glm::mix(from.m_translation, to.m_translation, a_alpha), 1.0f);
+
+            return world;
+        }
+
+        static glm::mat4 compose_local(const Transform& a_transform)
+        {
+            return compose_model_matrix(a_transform);
+        }
+    private:
+        struct HierarchyBlock
+        {
+            std::uint32_t m_begin;
+            std::uint32_t m_end;
+        };
+
+        std::uint32_t get_slot(EntityID a_id) const
+        {
+            std::uint32_t index = get_entity_index(a_id);
+
+            if(index >= m_slot_of_index.size())
+            {
+                return INVALID_HIERARCHY_SLOT;
+            }
+
+            std::uint32_t slot = m_slot_of_index[index];
+
+            return slot != INVALID_HIERARCHY_SLOT && m_slots[slot] == a_id ? slot : INVALID_HIERARCHY_SLOT;
+        }
+
+        //Changed transforms are gathered into one contiguous run so the whole batch goes through the kernel at once.
+        void update_changed_locals()
+        {
+            m_batch_locals.resize(m_batch_transforms.size());
+            compose_model_matrices(m_batch_transforms.data(), m_batch_transforms.size(), m_batch_locals.data());
+
+            for(size_t i = 0; i < m_batch_slots.size(); i++)
+            {
+                std::uint32_t slot = m_batch_slots[i];
+
+                m_local[slot] = m_batch_locals[i];
+                m_dirty[slot] = 1;
+                m_block_dirty[m_slot_blocks[slot]] = 1;
+            }
+        }
+
+        void rebuild_layout()
+        {
+            auto main_manager = MainManager::get_instance();
+
+            //Child lists of every entity, indexed by position in m_entities which is sorted.
+            //Only links between two entities with Transform count, others make the child a root.
+            auto contains = [this](EntityID a_id) {
+                return std::binary_search(m_entities.begin(), m_entities.end(), a_id);
+            };
+
+            std::vector<std::pair<std::uint32_t, EntityID>> edges;
+            main_manager->view<const Parent>().each([this, &edges, &contains](EntityID a_id, const Parent& a_parent) {
+                if(a_parent.m_parent != a_id && contains(a_id) && contains(a_parent.m_parent))
+                {
+                    auto parent = std::lower_bound(m_entities.begin(), m_entities.end(), a_parent.m_parent);
+                    edges.emplace_back(static_cast<std::uint32_t>(parent - m_entities.begin()), a_id);
+                }
+            });
+            std::sort(edges.begin(), edges.end());
+
+            std::vector<std::uint32_t> first_child(m_entities.size() + 1, 0);
+            for(const auto& edge : edges)
+            {
+                first_child[edge.first + 1]++;
+            }
+            for(size_t i = 1; i < first_child.size(); i++)
+            {
+                first_child[i] += first_child[i - 1];
+            }
+
+            std::vector<std::uint8_t> has_parent(m_entities.size(), 0);
+            for(const auto& edge : edges)
+            {
+                auto child = std::lower_bound(m_entities.begin(), m_entities.end(), edge.second);
+                has_parent[child - m_entities.begin()] = 1;
+            }
+
+            m_slots.clear();
+            m_parent_slots.clear();
+            m_slot_blocks.clear();
+            m_blocks.clear();
+            m_slot_of_index.assign(m_entities.empty() ? 0 : get_entity_index(m_entities.back()) + 1, INVALID_HIERARCHY_SLOT);
+
+            std::vector<std::uint32_t> position_of_slot;
+            auto add_slot = [&](size_t a_position, std::uint32_t a_parent_slot) {
+                m_slot_of_index[get_entity_index(m_entities[a_position])] = static_cast<std::uint32_t>(m_slots.size());
+                m_slots.push_back(m_entities[a_position]);
+                m_parent_slots.push_back(a_parent_slot);
+                m_slot_blocks.push_back(static_cast<std::uint32_t>(m_blocks.size()));
+                position_of_slot.push_back(static_cast<std::uint32_t>(a_position));
+            };
+            auto add_tree = [&](size_t a_root) {
+                std::uint32_t begin = static_cast<std::uint32_t>(m_slots.size());
+                add_slot(a_root, INVALID_HIERARCHY_SLOT);
+
+                //Slots appended so far double as the BFS queue.
+                for(std::uint32_t slot = begin; slot < m_slots.size(); slot++)
+                {
+                    std::uint32_t position = position_of_slot[slot];
+                    for(std::uint32_t edge = first_child[position]; edge < first_child[position + 1]; edge++)
+                    {
+                        auto child = std::lower_bound(m_entities.begin(), m_entities.end(), edges[edge].second);
+
+                        if(get_slot(*child) == INVALID_HIERARCHY_SLOT)
+                        {
+                            add_slot(child - m_entities.begin(), slot);
+                        }
+                    }
+                }
+
+                m_blocks.push_back(HierarchyBlock{ .m_begin = begin, .m_end = static_cast<std::uint32_t>(m_slots.size()) });
+            };
+
+            for(size_t i = 0; i < m_entities.size(); i++)
+            {
+                if(!has_parent[i])
+                {
+                    add_tree(i);
+                }
+            }
+
+            //Whatever is left is part of a cycle, break it at the first entity found.
+            for(size_t i = 0; i < m_entities.size(); i++)
+            {
+                if(get_slot(m_entities[i]) == INVALID_HIERARCHY_SLOT)
+                {
+                    LOG_WARNING("Parent cycle found at entity: {0}, treating it as root", m_entities[i]);
+                    add_tree(i);
+                }
+            }
+
+            m_local.resize(m_slots.size());
+            m_world.resize(m_slots.size());
+            m_dirty.assign(m_slots.size(), 1);
+            m_block_dirty.assign(m_blocks.size(), 1);
+            m_parent_count = main_manager->get_component_count<Parent>();
+
+            //Transforms in slot order, so the kernel writes straight into m_local.
+            m_batch_transforms.resize(m_slots.size());
+            main_manager->view<const Transform>(m_entities).each([this](EntityID a_id, const Transform& a_transform) {
+                m_batch_transforms[get_slot(a_id)] = a_transform;
+            });
+            compose_model_matrices(m_batch_transforms.data(), m_batch_transforms.size(), m_local.data());
+        }
+
+        struct WorldPose
+        {
+            glm::vec3 m_translation;
+            glm::quat m_rotation;
+            glm::vec3 m_scale;
+        };
+
+        //Splits a world matrix into translation, rotation and scale, shear from non uniformly scaled parents is
+        //dropped. False for degenerate matrices, which have no rotation to recover.
+        static bool decompose_world(const glm::mat4& a_world, WorldPose& a_pose)
+        {
+            glm::vec3 scale = glm::vec3(glm::length(glm::vec3(a_world[0])), glm::length(glm::vec3(a_world[1])), glm::length(glm::vec3(a_world[2])));
+
+            if(std::min({ scale.x, scale.y, scale.z }) < 1.0e-6f)
+            {
+                return false;
+            }
+
+            //Mirrored matrices keep the reflection in the scale, the rotation has to stay proper.
+            if(glm::determinant(glm::mat3(a_world)) < 0.0f)
+            {
+                scale.x = -scale.x;
+            }
+
+            glm::mat3 rotation = glm::mat3(glm::vec3(a_world[0]) / scale.x, glm::vec3(a_world[1]) / scale.y, glm::vec3(a_world[2]) / scale.z);
+            a_pose = WorldPose{ .m_translation = glm::vec3(a_world[3]), .m_rotation = glm::quat_cast(rotation), .m_scale = scale };
+
+            return true;
+        }
+
+        //Blocks which didn't move in the last update have their previous world matrices equal to the current ones
+        //already, only the ones which did have to catch up.
+        void catch_up_previous_world()
+        {
+            for(std::uint32_t block : m_moved_blocks)
+            {
+                std::copy(m_world.begin() + m_blocks[block].m_begin, m_world.begin() + m_blocks[block].m_end, m_previous_world.begin() + m_blocks[block].m_begin);
+            }
+
+            m_moved_blocks.clear();
+        }
+
+        //Dirty blocks are kept in m_moved_blocks for the next catch_up_previous_world.
+        void propagate()
+        {
+            for(std::uint32_t block = 0; block < m_blocks.size(); block++)
+            {
+                if(m_block_dirty[block])
+                {
+                    m_moved_blocks.push_back(block);
+                }
+            }
+
+            auto range_func = [this](size_t a_begin, size_t a_end, size_t) {
+                for(size_t i = a_begin; i < a_end; i++)
+                {
+                    propagate_block(m_blocks[m_moved_blocks[i]]);
+                    m_block_dirty[m_moved_blocks[i]] = 0;
+                }
+            };
+
+            TPool* pool = TPool::get_instance();
+            if(!pool)
+            {
+                range_func(0, m_moved_blocks.size(), 0);
+                return;
+            }
+
+            pool->parallel_for(m_moved_blocks.size(), HIERARCHY_BLOCKS_GRAIN, range_func);
+        }
+
+        //Dirty flag flows from parent to children, clean subtrees of a dirty block are only checked, not recomputed.
+        void propagate_block(const HierarchyBlock& a_block)
+        {
+            for(std::uint32_t slot = a_block.m_begin; slot < a_block.m_end; slot++)
+            {
+                std::uint32_t parent = m_parent_slots[slot];
+
+                if(parent != INVALID_HIERARCHY_SLOT && m_dirty[parent])
+                {
+                    m_dirty[slot] = 1;
+                }
+
+                if(!m_dirty[slot])
+                {
+                    continue;
+                }
+
+                m_world[slot] = parent != INVALID_HIERARCHY_SLOT ? m_world[parent] * m_local[slot] : m_local[slot];
+            }
+
+            std::fill(m_dirty.begin() + a_block.m_begin, m_dirty.begin() + a_block.m_end, 0);
+        }
+    private:
+        std::vector<EntityID>       m_slots;
+        std::vector<std::uint32_t>  m_parent_slots;
+        std::vector<std::uint32_t>  m_slot_blocks;
+        std::vector<glm::mat4>      m_local;
+        std::vector<glm::mat4>      m_world;
+        std::vector<glm::mat4>      m_previous_world;
+        std::vector<std::uint8_t>   m_dirty;
+        std::vector<HierarchyBlock> m_blocks;
+        std::vector<std::uint8_t>   m_block_dirty;
+        std::vector<std::uint32_t>  m_moved_blocks;
+        std::vector<std::uint32_t>  m_slot_of_index;
+        std::vector<std::uint32_t>  m_batch_slots;
+        std::vector<Transform>      m_batch_transforms;
+        std::vector<glm::mat4>      m_batch_locals;
+        size_t                      m_parent_count = 0;
+        bool                        m_world_restored = false;
+        glm::mat4                   m_identity = glm::mat4(1.0f);
+    };
+}
+
+#endif //MAIN_TRANSFORMSYSTEM_H
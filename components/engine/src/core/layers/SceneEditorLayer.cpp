@@ -70,7 +70,7 @@ namespace vis
 
     void SceneEditorLayer::on_update(float a_dt)
     {
-        m_physics_system->on_update(a_dt);
+        MainManager::get_instance()->update_systems(a_dt);
 
         if(m_mouse_move_mode_enabled)
         {
@@ -83,7 +83,7 @@ namespace vis
     {
         Renderer::render_skybox(m_skybox, m_skybox_shader);
         Renderer::render_grid(m_grid, m_grid_shader);
-        m_renderer_system->on_render();
+        m_renderer_system->on_render(Application::get_instance()->get_interpolation_alpha());
     }
 
     void SceneEditorLayer::on_imgui_render()
@@ -122,10 +122,15 @@ namespace vis
         MainManager::get_instance()->register_component<RigidBody>();
         MainManager::get_instance()->register_component<MeshComponent>();
         MainManager::get_instance()->register_component<SceneCamera>();
+        MainManager::get_instance()->register_component<Parent>();
 
         //Register all system
         m_physics_system = MainManager::get_instance()->register_system<PhysicsSystem>();
+        m_transform_system = MainManager::get_instance()->register_system<TransformSystem>();
+        m_spatial_system = MainManager::get_instance()->register_system<SpatialHashSystem>();
+        m_broadphase_system = MainManager::get_instance()->register_system<BroadphaseSystem>();
         m_renderer_system = MainManager::get_instance()->register_system<RendererSystem>();
+        m_renderer_system->set_transform_system(m_transform_system);
 
         //Set system signatures
         Signature phys_signature;
@@ -133,16 +138,27 @@ namespace vis
         phys_signature.set(MainManager::get_instance()->get_component_type<RigidBody>(), true);
         MainManager::get_instance()->set_system_signature<PhysicsSystem>(phys_signature);
 
+        MainManager::get_instance()->set_system_signature<TransformSystem>(MainManager::get_instance()->make_signature<Transform>());
+        MainManager::get_instance()->set_system_signature<SpatialHashSystem>(MainManager::get_instance()->make_signature<Transform>());
+        MainManager::get_instance()->set_system_signature<BroadphaseSystem>(phys_signature);
+
         Signature rend_signature;
         rend_signature.set(MainManager::get_instance()->get_component_type<MeshComponent>(), true);
         rend_signature.set(MainManager::get_instance()->get_component_type<Color>(), true);
         rend_signature.set(MainManager::get_instance()->get_component_type<Transform>(), true);
         MainManager::get_instance()->set_system_signature<RendererSystem>(rend_signature);
 
+        //Declare component access so the scheduler knows which systems may run in parallel
+        MainManager::get_instance()->set_system_access<PhysicsSystem>(phys_signature, phys_signature);
+        MainManager::get_instance()->set_system_access<TransformSystem>(MainManager::get_instance()->make_signature<Transform, Parent>(), Signature());
+        MainManager::get_instance()->set_system_access<SpatialHashSystem>(MainManager::get_instance()->make_signature<Transform>(), Signature());
+        MainManager::get_instance()->set_system_access<BroadphaseSystem>(phys_signature, Signature());
+        MainManager::get_instance()->set_system_access<RendererSystem>(rend_signature, Signature());
+
         m_components_names = {"Transform", "Color", "Mesh", "RigidBody", "Camera"};
     }
 
-    void SceneEditorLayer::render_transform_component(std::uint16_t a_id)
+    void SceneEditorLayer::render_transform_component(EntityID a_id)
     {
         Signature sig = MainManager::get_instance()->get_entity_signature(a_id);
 
@@ -162,7 +178,7 @@ namespace vis
         }
     }
 
-    void SceneEditorLayer::render_color_component(std::uint16_t a_id)
+    void SceneEditorLayer::render_color_component(EntityID a_id)
     {
         Signature sig = MainManager::get_instance()->get_entity_signature(a_id);
 
@@ -179,7 +195,7 @@ namespace vis
         }
     }
 
-    void SceneEditorLayer::render_mesh_component(std::uint16_t a_id)
+    void SceneEditorLayer::render_mesh_component(EntityID a_id)
     {
         Signature sig = MainManager::get_instance()->get_entity_signature(a_id);
 
@@ -212,7 +228,7 @@ namespace vis
         }
     }
 
-    void SceneEditorLayer::render_camera_component(std::uint16_t a_id)
+    void SceneEditorLayer::render_camera_component(EntityID a_id)
     {
         Signature sig = MainManager::get_instance()->get_entity_signature(a_id);
 
@@ -238,7 +254,7 @@ namespace vis
         }
     }
 
-    void SceneEditorLayer::render_add_component_button(std::uint16_t a_id)
+    void SceneEditorLayer::render_add_component_button(EntityID a_id)
     {
         ImVec2 button_size = ImVec2(ImGui::GetWindowWidth() * 0.8f, ImGui::GetTextLineHeight() * 1.4f);
 
@@ -257,7 +273,7 @@ namespace vis
         }
     }
 
-    void SceneEditorLayer::add_component_to_entity(std::uint16_t a_id, const char *a_component_name)
+    void SceneEditorLayer::add_component_to_entity(EntityID a_id, const char *a_component_name)
     {
         if (std::strcmp(a_component_name, "Transform") == 0)
         {
@@ -296,11 +312,11 @@ namespace vis
 
     void SceneEditorLayer::render_imgui_ecs_window()
     {
-        std::uint16_t id = MainManager::get_instance()->get_current_entity();
+        EntityID id = MainManager::get_instance()->get_current_entity();
 
         ImGui::Begin("Properties");
 
-        if (id != MAX_ENTITIES) {
+        if (id != NULL_ENTITY) {
             Theme current_theme = ColorSchemeEditor::get_current_theme();
 
             ImGui::PushStyleColor(ImGuiCol_Header, ColorSchemeEditor::get_color(current_theme.background, ColorSchemeEditor::m_alpha_100));
@@ -330,8 +346,9 @@ namespace vis
     void SceneEditorLayer::initialize_scene_hierarchy()
     {
         m_scene_hierarchy_flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
-        m_selected_entity = MAX_ENTITIES;
-        m_id_to_perform_action = MAX_ENTITIES;
+        m_selected_entity = NULL_ENTITY;
+        m_id_to_perform_action = NULL_ENTITY;
+        m_copied_entity = NULL_ENTITY;
     }
 
     void SceneEditorLayer::render_scene_hierarchy()
@@ -339,7 +356,7 @@ namespace vis
         ImGui::Begin("Scene Hierarchy");
         bool selected = false;
         ImGuiTreeNodeFlags flags = m_scene_hierarchy_flags;
-        std::uint16_t i = 0;
+        std::uint32_t i = 0;
 
         if (ImGui::TreeNode(SceneManager::get()->get_current_scene()->get_name().c_str())) {
             auto &m_scene_entities = SceneManager::get()->get_current_scene()->get_entities();
@@ -350,9 +367,10 @@ namespace vis
                 } else
                     selected = false;
 
-                if (ImGui::Selectable(MainManager::get_instance()->get_entity(*it).get_name().c_str(), selected)) {
+                //Interned names are null terminated, no copy needed for ImGui.
+                if (ImGui::Selectable(MainManager::get_instance()->get_entity_name(*it).data(), selected)) {
                     m_selected_entity = i;
-                    m_id_to_perform_action = MAX_ENTITIES;
+                    m_id_to_perform_action = NULL_ENTITY;
                 }
                 if (!m_mouse_move_mode_enabled && ImGui::IsItemHovered() && ImGui::IsMouseReleased(ImGuiMouseButton_Right)) {
                     m_id_to_perform_action = *it;
@@ -375,10 +393,10 @@ namespace vis
 
         if (ImGui::BeginPopup("Options")) {
             if (ImGui::MenuItem("Copy")) {
-
+                copy_entity(m_id_to_perform_action);
             }
             if (ImGui::MenuItem("Paste")) {
-
+                paste_entity();
             }
             if (ImGui::MenuItem("Rename")) {
 
@@ -412,24 +430,32 @@ namespace vis
         LOG_INFO("RENAME ENTITY");
     }
 
-    void SceneEditorLayer::copy_entity()
+    void SceneEditorLayer::copy_entity(EntityID a_id)
     {
-        LOG_INFO("COPY ENTITY");
+        m_copied_entity = a_id != NULL_ENTITY ? a_id : MainManager::get_instance()->get_current_entity();
     }
 
     void SceneEditorLayer::paste_entity()
     {
-        LOG_INFO("PASTE ENTITY");
+        if (!MainManager::get_instance()->is_alive(m_copied_entity)) {
+            LOG_WARNING("Copied entity no longer exists!");
+            m_copied_entity = NULL_ENTITY;
+            return;
+        }
+
+        EntityID pasted = MainManager::get_instance()->clone_entity(m_copied_entity);
+        SceneManager::get()->get_current_scene()->add_entity(pasted);
+        MainManager::get_instance()->set_current_entity(pasted);
     }
 
-    void SceneEditorLayer::delete_entity(std::uint16_t a_id)
+    void SceneEditorLayer::delete_entity(EntityID a_id)
     {
-        if (a_id != MAX_ENTITIES) {
+        if (a_id != NULL_ENTITY) {
             SceneManager::get()->get_current_scene()->remove_entity(a_id);
             MainManager::get_instance()->destroy_entity(a_id);
-            MainManager::get_instance()->set_current_entity(MAX_ENTITIES);
-            m_id_to_perform_action = MAX_ENTITIES;
-            m_selected_entity = MAX_ENTITIES;
+            MainManager::get_instance()->set_current_entity(NULL_ENTITY);
+            m_id_to_perform_action = NULL_ENTITY;
+            m_selected_entity = NULL_ENTITY;
         }
     }
 
@@ -806,10 +832,38 @@ namespace vis
                 ImGui::EndMenu();
             }
 
+            if(!m_play_snapshot && ImGui::MenuItem("Play"))
+            {
+                start_play_mode();
+            }
+            else if(m_play_snapshot && ImGui::MenuItem("Stop"))
+            {
+                stop_play_mode();
+            }
+
+            ImGui::Text("Drawn: %zu Culled: %zu", m_renderer_system->get_drawn_count(), m_renderer_system->get_culled_count());
+
             ImGui::EndMainMenuBar();
         }
     }
 
+    void SceneEditorLayer::start_play_mode()
+    {
+        m_play_snapshot = MainManager::get_instance()->take_snapshot();
+        m_play_scene_entities = SceneManager::get()->get_current_scene()->get_entities();
+    }
+
+    void SceneEditorLayer::stop_play_mode()
+    {
+        MainManager::get_instance()->restore_snapshot(*m_play_snapshot);
+        SceneManager::get()->get_current_scene()->get_entities() = m_play_scene_entities;
+
+        m_play_snapshot.reset();
+        m_play_scene_entities.clear();
+        m_selected_entity = NULL_ENTITY;
+        m_id_to_perform_action = NULL_ENTITY;
+    }
+
     void SceneEditorLayer::render_transform_slider(const std::string& label,glm::vec3* data, float pos_to_add, float speed, float min)
     {
         float tag_padding = ImGui::GetWindowWidth() / 20.0f;
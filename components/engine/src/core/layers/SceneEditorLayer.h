@@ -13,6 +13,8 @@
 #include "Layer.h"
 #include "ecs/MainManager.h"
 #include "ecs/systems/BasicSystems.h"
+#include "ecs/systems/SpatialHashSystem.h"
+#include "ecs/systems/BroadphaseSystem.h"
 #include "ecs/components/BasicComponents.h"
 #include "ecs/components/SceneCamera.h"
 #include "managers/SceneManager.h"
@@ -36,12 +38,12 @@ namespace vis
     private:
         //ECS rendering, adding and initialization
         void initialize_ecs_system();
-        void render_mesh_component(std::uint16_t a_id);
-        void render_transform_component(std::uint16_t a_id);
-        void render_color_component(std::uint16_t a_id);
-        void render_camera_component(std::uint16_t a_id);
-        void render_add_component_button(std::uint16_t a_id);
-        void add_component_to_entity(std::uint16_t a_id, const char* a_component_name);
+        void render_mesh_component(EntityID a_id);
+        void render_transform_component(EntityID a_id);
+        void render_color_component(EntityID a_id);
+        void render_camera_component(EntityID a_id);
+        void render_add_component_button(EntityID a_id);
+        void add_component_to_entity(EntityID a_id, const char* a_component_name);
         void render_imgui_ecs_window();
         void render_transform_slider(const std::string& label, glm::vec3* data, float pos_to_add, float speed = 0.01f, float min = -FLT_MAX);
 
@@ -50,9 +52,9 @@ namespace vis
         void render_scene_hierarchy();
         void render_hierarchy_popup();
         void rename_entity();
-        void copy_entity();
+        void copy_entity(EntityID a_id);
         void paste_entity();
-        void delete_entity(std::uint16_t a_id);
+        void delete_entity(EntityID a_id);
 
         //Assets panel
         void initialize_assets_panel();
@@ -71,8 +73,15 @@ namespace vis
         void on_window_resize_event(WindowResizeEvent& a_event);
         void move_camera(float dt);
         void render_menu_bar();
+
+        //Play mode, stopping restores the world and scene as they were when play started
+        void start_play_mode();
+        void stop_play_mode();
     private:
         std::shared_ptr<PhysicsSystem>   m_physics_system;
+        std::shared_ptr<TransformSystem> m_transform_system;
+        std::shared_ptr<SpatialHashSystem> m_spatial_system;
+        std::shared_ptr<BroadphaseSystem> m_broadphase_system;
         std::shared_ptr<RendererSystem>  m_renderer_system;
         std::vector<const char*>         m_components_names;
 
@@ -83,8 +92,12 @@ namespace vis
         Shader*                          m_grid_shader;
         Shader*                          m_skybox_shader;
         std::string                      m_default_mesh_path;
-        std::uint16_t                    m_selected_entity;
-        std::uint16_t                    m_id_to_perform_action;
+        std::uint32_t                    m_selected_entity;
+        EntityID                         m_id_to_perform_action;
+        EntityID                         m_copied_entity;
+
+        std::unique_ptr<WorldSnapshot>   m_play_snapshot;
+        std::set<EntityID>               m_play_scene_entities;
 
         std::unordered_map<std::string, Texture*> m_icons;
         float                            m_mini_icon_zoom;
@@ -3,6 +3,10 @@
 //
 
 #include <fstream>
+#include <charconv>
+#include <algorithm>
+#include <cstring>
+#include <new>
 
 #include "SerializationManager.h"
 #include "ecs/MainManager.h"
@@ -11,9 +15,347 @@ namespace vis
 {
     SerializationManager* SerializationManager::m_instance;
     float                 SerializationManager::m_version;
+    std::uint32_t         SerializationManager::m_binary_version;
     std::string           SerializationManager::m_component_prefix;
     std::string           SerializationManager::m_default_offset;
 
+    namespace
+    {
+        constexpr char          BINARY_MAGIC[4] = { 'V', 'I', 'S', 'B' };
+        constexpr std::uint32_t INVALID_INDEX = UINT32_MAX;
+
+        //Components of one type packed like an array of it, constructed with the buffer and destroyed with it.
+        class ComponentBuffer
+        {
+        public:
+            ComponentBuffer(const TypeInfo& type, size_t count)
+            : m_type(type), m_count(count), m_data(nullptr)
+            {
+                if(count == 0)
+                {
+                    return;
+                }
+
+                m_data = static_cast<std::byte*>(::operator new(count * type.m_size, std::align_val_t(type.m_alignment)));
+                for(size_t i = 0; i < count; i++)
+                {
+                    type.m_construct(get(i));
+                }
+            }
+
+            ~ComponentBuffer()
+            {
+                if(!m_data)
+                {
+                    return;
+                }
+
+                for(size_t i = 0; i < m_count; i++)
+                {
+                    m_type.m_destroy(get(i));
+                }
+
+                ::operator delete(m_data, std::align_val_t(m_type.m_alignment));
+            }
+
+            ComponentBuffer(const ComponentBuffer& other) = delete;
+            ComponentBuffer& operator=(const ComponentBuffer& other) = delete;
+
+            std::byte* get(size_t index)
+            {
+                return m_data + index * m_type.m_size;
+            }
+
+            std::byte* data()
+            {
+                return m_data;
+            }
+        private:
+            const TypeInfo& m_type;
+            size_t          m_count;
+            std::byte*      m_data;
+        };
+
+        //Position of id among the sorted scene entities, hint is tried first since component runs are mostly sorted too.
+        std::uint32_t find_entity(const std::vector<EntityID>& entities, EntityID id, std::uint32_t& hint)
+        {
+            if(hint < entities.size() && entities[hint] == id)
+            {
+                return hint++;
+            }
+
+            auto it = std::lower_bound(entities.begin(), entities.end(), id);
+            if(it == entities.end() || *it != id)
+            {
+                return INVALID_INDEX;
+            }
+
+            hint = static_cast<std::uint32_t>(it - entities.begin()) + 1;
+
+            return hint - 1;
+        }
+
+        //Entity fields are saved as positions of the referenced entities in the scene, INVALID_INDEX for none.
+        void entity_fields_to_indices(const TypeInfo& type, std::byte* data, const std::vector<EntityID>& entities)
+        {
+            std::uint32_t hint = 0;
+
+            for(const FieldInfo& field : type.m_fields)
+            {
+                if(field.m_type != FieldType::ENTITY)
+                {
+                    continue;
+                }
+
+                EntityID id;
+                std::memcpy(&id, data + field.m_offset, sizeof(id));
+                std::uint32_t index = find_entity(entities, id, hint);
+                std::memcpy(data + field.m_offset, &index, sizeof(index));
+            }
+        }
+
+        //Entity fields missing from the file or failing to load stay INVALID_INDEX and become NULL_ENTITY.
+        void reset_entity_fields(const TypeInfo& type, std::byte* data)
+        {
+            for(const FieldInfo& field : type.m_fields)
+            {
+                if(field.m_type == FieldType::ENTITY)
+                {
+                    std::memcpy(data + field.m_offset, &INVALID_INDEX, sizeof(INVALID_INDEX));
+                }
+            }
+        }
+
+        void entity_fields_to_handles(const TypeInfo& type, std::byte* data, const std::vector<EntityID>& entities)
+        {
+            for(const FieldInfo& field : type.m_fields)
+            {
+                if(field.m_type != FieldType::ENTITY)
+                {
+                    continue;
+                }
+
+                std::uint32_t index;
+                std::memcpy(&index, data + field.m_offset, sizeof(index));
+                EntityID id = index < entities.size() ? entities[index] : NULL_ENTITY;
+                std::memcpy(data + field.m_offset, &id, sizeof(id));
+            }
+        }
+
+        //Loaded components reference entities by position in the scene, elements are positions of their owners.
+        void add_loaded_components(const TypeInfo& type, ComponentBuffer& buffer, const std::vector<std::uint32_t>& elements, const std::vector<EntityID>& entities)
+        {
+            std::vector<EntityID> ids(elements.size());
+
+            for(size_t i = 0; i < elements.size(); i++)
+            {
+                ids[i] = entities[elements[i]];
+
+                if(type.m_has_entity_fields)
+                {
+                    entity_fields_to_handles(type, buffer.get(i), entities);
+                }
+            }
+
+            MainManager::get_instance()->add_components_erased(type, ids.data(), ids.size(), buffer.data());
+        }
+
+        void write_float(std::ofstream& output, float value)
+        {
+            char text[32];
+            auto result = std::to_chars(text, text + sizeof(text), value);
+            output.write(text, result.ptr - text);
+        }
+
+        void write_text_field(const FieldInfo& field, const std::byte* data, const std::vector<EntityID>& entities, std::ofstream& output)
+        {
+            const std::byte* value = data + field.m_offset;
+
+            switch(field.m_type)
+            {
+                case FieldType::BOOL:
+                {
+                    bool flag;
+                    std::memcpy(&flag, value, sizeof(flag));
+                    output << flag;
+                    break;
+                }
+                case FieldType::INT32:
+                {
+                    std::int32_t number;
+                    std::memcpy(&number, value, sizeof(number));
+                    output << number;
+                    break;
+                }
+                case FieldType::UINT32:
+                {
+                    std::uint32_t number;
+                    std::memcpy(&number, value, sizeof(number));
+                    output << number;
+                    break;
+                }
+                case FieldType::FLOAT:
+                {
+                    float number;
+                    std::memcpy(&number, value, sizeof(number));
+                    write_float(output, number);
+                    break;
+                }
+                case FieldType::VEC2:
+                case FieldType::VEC3:
+                case FieldType::VEC4:
+                {
+                    output << "{ ";
+                    for(size_t i = 0; i < get_field_size(field.m_type) / sizeof(float); i++)
+                    {
+                        float number;
+                        std::memcpy(&number, value + i * sizeof(float), sizeof(number));
+                        output << (i > 0 ? " , " : "");
+                        write_float(output, number);
+                    }
+                    output << " }";
+                    break;
+                }
+                case FieldType::ENTITY:
+                {
+                    //Anchor of the referenced GameObject, 0 is the anchor of the scene and means no entity.
+                    EntityID id;
+                    std::uint32_t hint = 0;
+                    std::memcpy(&id, value, sizeof(id));
+                    std::uint32_t index = find_entity(entities, id, hint);
+                    output << (index == INVALID_INDEX ? 0 : index + 1);
+                    break;
+                }
+            }
+        }
+
+        template<typename T>
+        bool parse_number(std::string_view text, T& value)
+        {
+            while(!text.empty() && text.front() == ' ')
+            {
+                text.remove_prefix(1);
+            }
+
+            return std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc();
+        }
+
+        //Entity fields keep the anchor, the caller turns it into the position of the entity in the scene.
+        bool read_text_field(const FieldInfo& field, std::string_view text, std::byte* data)
+        {
+            std::byte* value = data + field.m_offset;
+
+            switch(field.m_type)
+            {
+                case FieldType::BOOL:
+                {
+                    int number;
+                    if(!parse_number(text, number))
+                    {
+                        return false;
+                    }
+
+                    bool flag = number != 0;
+                    std::memcpy(value, &flag, sizeof(flag));
+                    return true;
+                }
+                case FieldType::INT32:
+                {
+                    std::int32_t number;
+                    if(!parse_number(text, number))
+                    {
+                        return false;
+                    }
+
+                    std::memcpy(value, &number, sizeof(number));
+                    return true;
+                }
+                case FieldType::UINT32:
+                case FieldType::ENTITY:
+                {
+                    std::uint32_t number;
+                    if(!parse_number(text, number))
+                    {
+                        return false;
+                    }
+
+                    std::memcpy(value, &number, sizeof(number));
+                    return true;
+                }
+                case FieldType::FLOAT:
+                {
+                    float number;
+                    if(!parse_number(text, number))
+                    {
+                        return false;
+                    }
+
+                    std::memcpy(value, &number, sizeof(number));
+                    return true;
+                }
+                case FieldType::VEC2:
+                case FieldType::VEC3:
+                case FieldType::VEC4:
+                {
+                    size_t count = get_field_size(field.m_type) / sizeof(float);
+                    size_t position = text.find('{');
+
+                    for(size_t i = 0; i < count; i++)
+                    {
+                        if(position == std::string_view::npos)
+                        {
+                            return false;
+                        }
+
+                        float number;
+                        if(!parse_number(text.substr(position + 1), number))
+                        {
+                            return false;
+                        }
+
+                        std::memcpy(value + i * sizeof(float), &number, sizeof(number));
+                        position = text.find(',', position + 1);
+                    }
+
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        template<typename T>
+        void write_value(std::ofstream& output, const T& value)
+        {
+            output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void write_string(std::ofstream& output, std::string_view text)
+        {
+            write_value(output, static_cast<std::uint32_t>(text.size()));
+            output.write(text.data(), static_cast<std::streamsize>(text.size()));
+        }
+
+        template<typename T>
+        bool read_value(std::ifstream& input, T& value)
+        {
+            return static_cast<bool>(input.read(reinterpret_cast<char*>(&value), sizeof(T)));
+        }
+
+        bool read_string(std::ifstream& input, std::string& text)
+        {
+            std::uint32_t size;
+            if(!read_value(input, size) || size > UINT16_MAX)
+            {
+                return false;
+            }
+
+            text.resize(size);
+
+            return static_cast<bool>(input.read(text.data(), size));
+        }
+    }
+
     SerializationManager *SerializationManager::get()
     {
         if(!m_instance)
@@ -33,6 +375,7 @@ namespace vis
         }
 
         m_version = 0.1f;
+        m_binary_version = 1;
         m_element_to_id.insert({ELEMENT_TYPE::UNDEFINED, 0});
         m_element_to_id.insert({ELEMENT_TYPE::SCENE, 1});
         m_element_to_id.insert({ELEMENT_TYPE::GAME_OBJECT, 2});
@@ -58,7 +401,7 @@ namespace vis
     bool SerializationManager::serialize_scene(Scene *scene, const std::string &path)
     {
         std::ofstream file(path);
-        std::uint16_t current_element_number = 0;
+        std::uint32_t current_element_number = 0;
 
         if(!file.is_open())
         {
@@ -71,9 +414,12 @@ namespace vis
         serialize_scene_data(scene, current_element_number,file);
         current_element_number++;
 
-        for(const auto& entity : scene->get_entities())
+        std::vector<EntityID> entities(scene->get_entities().begin(), scene->get_entities().end());
+        ComponentTable components = collect_components(entities);
+
+        for(std::uint32_t i = 0; i < entities.size(); i++)
         {
-            serialize_entity_info(current_element_number, entity, file);
+            serialize_entity_info(current_element_number, i, entities, components, file);
             current_element_number++;
         }
 
@@ -81,115 +427,539 @@ namespace vis
 
         LOG_INFO("Successfully saved file: {0}", path.c_str());
 
-        return false;
+        return true;
     }
 
     Scene *SerializationManager::deserialize_scene(const std::string &path)
     {
-        return nullptr;
+        std::ifstream file(path);
+
+        if(!file.is_open())
+        {
+            LOG_ERROR("Failed to open file for deserialization: {0}", path.c_str());
+            return nullptr;
+        }
+
+        struct ParsedComponent
+        {
+            const TypeInfo*                                  m_type;
+            std::uint32_t                                    m_element;
+            std::vector<std::pair<std::string, std::string>> m_fields;
+        };
+
+        std::string scene_name;
+        std::vector<std::string> names;
+        std::vector<int> types;
+        std::vector<ParsedComponent> parsed;
+        std::unordered_map<std::uint32_t, std::uint32_t> anchor_to_index;
+        std::uint32_t anchor = 0;
+        ELEMENT_TYPE element = ELEMENT_TYPE::UNDEFINED;
+        auto main_manager = MainManager::get_instance();
+
+        std::string line;
+        while(std::getline(file, line))
+        {
+            if(!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            if(line.rfind("--- !u!", 0) == 0)
+            {
+                size_t position = line.find('&');
+                element = ELEMENT_TYPE::UNDEFINED;
+
+                if(position == std::string::npos || !parse_number(std::string_view(line).substr(position + 1), anchor))
+                {
+                    LOG_WARNING("Missing anchor in line: {0}", line.c_str());
+                }
+            }
+            else if(line == "Scene:")
+            {
+                element = ELEMENT_TYPE::SCENE;
+            }
+            else if(line == "GameObject:")
+            {
+                element = ELEMENT_TYPE::GAME_OBJECT;
+                anchor_to_index[anchor] = static_cast<std::uint32_t>(names.size());
+                names.emplace_back();
+                types.push_back(0);
+            }
+            else if(line.rfind(m_component_prefix, 0) == 0)
+            {
+                size_t separator = line.find(": ");
+
+                if(element == ELEMENT_TYPE::GAME_OBJECT && !parsed.empty() && separator != std::string::npos)
+                {
+                    parsed.back().m_fields.emplace_back(line.substr(m_component_prefix.size(), separator - m_component_prefix.size()), line.substr(separator + 2));
+                }
+            }
+            else if(line.rfind(m_default_offset, 0) == 0)
+            {
+                std::string_view content = std::string_view(line).substr(m_default_offset.size());
+
+                if(content.rfind("m_Name: ", 0) == 0 && element != ELEMENT_TYPE::UNDEFINED)
+                {
+                    (element == ELEMENT_TYPE::SCENE ? scene_name : names.back()) = content.substr(8);
+                }
+                else if(content.rfind("m_Type: ", 0) == 0 && element == ELEMENT_TYPE::GAME_OBJECT)
+                {
+                    parse_number(content.substr(8), types.back());
+                }
+                else if(!content.empty() && content.back() == ':' && element == ELEMENT_TYPE::GAME_OBJECT)
+                {
+                    content.remove_suffix(1);
+                    const TypeInfo* type = main_manager->get_reflection_registry().find_type(content);
+
+                    if(!type)
+                    {
+                        LOG_WARNING("Skipping unknown component: {0}", std::string(content).c_str());
+                    }
+
+                    parsed.push_back(ParsedComponent{ .m_type = type, .m_element = static_cast<std::uint32_t>(names.size() - 1) });
+                }
+            }
+        }
+
+        std::vector<EntityID> entities = main_manager->create_entities(names.size());
+        for(size_t i = 0; i < entities.size(); i++)
+        {
+            main_manager->set_entity_name(entities[i], names[i]);
+            main_manager->set_entity_type(entities[i], static_cast<EntityType>(types[i]));
+        }
+
+        //Components of one type are added together, in order of their owners.
+        parsed.erase(std::remove_if(parsed.begin(), parsed.end(), [](const ParsedComponent& component) { return !component.m_type; }), parsed.end());
+        std::stable_sort(parsed.begin(), parsed.end(), [](const ParsedComponent& lhs, const ParsedComponent& rhs) {
+            return lhs.m_type->m_component_type < rhs.m_type->m_component_type;
+        });
+
+        for(size_t begin = 0, end = 0; begin < parsed.size(); begin = end)
+        {
+            const TypeInfo& type = *parsed[begin].m_type;
+            while(end < parsed.size() && parsed[end].m_type == &type)
+            {
+                end++;
+            }
+
+            ComponentBuffer buffer(type, end - begin);
+            std::vector<std::uint32_t> elements;
+
+            for(size_t i = begin; i < end; i++)
+            {
+                std::byte* data = buffer.get(i - begin);
+                elements.push_back(parsed[i].m_element);
+                reset_entity_fields(type, data);
+
+                for(const auto& [name, value] : parsed[i].m_fields)
+                {
+                    const FieldInfo* field = type.find_field(name);
+
+                    if(!field || !read_text_field(*field, value, data))
+                    {
+                        LOG_WARNING("Skipping field: {0} of component: {1}", name.c_str(), type.m_name.data());
+                        continue;
+                    }
+
+                    if(field->m_type == FieldType::ENTITY)
+                    {
+                        std::uint32_t reference;
+                        std::memcpy(&reference, data + field->m_offset, sizeof(reference));
+                        auto it = anchor_to_index.find(reference);
+                        std::uint32_t index = it != anchor_to_index.end() ? it->second : INVALID_INDEX;
+                        std::memcpy(data + field->m_offset, &index, sizeof(index));
+                    }
+                }
+            }
+
+            add_loaded_components(type, buffer, elements, entities);
+        }
+
+        LOG_INFO("Successfully loaded file: {0}", path.c_str());
+
+        return new Scene(scene_name, std::set<EntityID>(entities.begin(), entities.end()));
     }
 
-    void SerializationManager::serialize_entity_info(std::uint16_t number, std::uint16_t entity_id, std::ofstream& output)
+    bool SerializationManager::serialize_scene_binary(Scene *scene, const std::string &path)
     {
-        auto main_manager = MainManager::get_instance();
+        std::ofstream file(path, std::ios::binary);
 
-        output << "--- !u!" << m_element_to_id.at(ELEMENT_TYPE::GAME_OBJECT) << " ";
-        output << "&" << number << '\n';
-        output << "GameObject:\n";
-        output << m_default_offset << "m_Name: " << main_manager->get_entity(entity_id).get_name() << '\n';
+        if(!file.is_open())
+        {
+            LOG_ERROR("Failed to open file for serialization: {0}", path.c_str());
+            return false;
+        }
+
+        auto main_manager = MainManager::get_instance();
+        std::vector<EntityID> entities(scene->get_entities().begin(), scene->get_entities().end());
 
-        Signature sig = main_manager->get_entity_signature(entity_id);
+        file.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        write_value(file, m_binary_version);
+        write_string(file, scene->get_name());
 
-        if(sig[main_manager->get_component_type<Transform>()])
+        write_value(file, static_cast<std::uint32_t>(entities.size()));
+        for(EntityID id : entities)
         {
-            const auto& transform = main_manager->get_component<Transform>(entity_id);
-            serialize_transform_component(transform, output);
+            write_string(file, main_manager->get_entity_name(id));
+            write_value(file, static_cast<std::uint8_t>(main_manager->get_entity(id).get_type()));
         }
-        if(sig[main_manager->get_component_type<Color>()])
+
+        const ReflectionRegistry& registry = main_manager->get_reflection_registry();
+        std::uint32_t block_count = 0;
+        for(size_t type = 0; type < registry.get_type_count(); type++)
         {
-            const auto& color = main_manager->get_component<Color>(entity_id);
-            serialize_color_component(color, output);
+            block_count += registry.get_type(static_cast<ComponentType>(type)) != nullptr;
         }
-        if(sig[main_manager->get_component_type<MeshComponent>()])
+
+        write_value(file, block_count);
+        for(size_t type = 0; type < registry.get_type_count(); type++)
         {
-            const auto& mesh = main_manager->get_component<MeshComponent>(entity_id);
-            serialize_mesh_component(mesh, output);
+            if(const TypeInfo* info = registry.get_type(static_cast<ComponentType>(type)))
+            {
+                serialize_component_block(*info, entities, file);
+            }
         }
-        if(sig[main_manager->get_component_type<SceneCamera>()])
+
+        if(!file)
         {
-            auto& scene_camera = main_manager->get_component<SceneCamera>(entity_id);
-            serialize_scene_camera_component(scene_camera, output);
+            LOG_ERROR("Failed to write file: {0}", path.c_str());
+            return false;
         }
-    }
 
-    SerializationManager::ELEMENT_TYPE SerializationManager::deserialize_entity_info(std::string line)
-    {
-        return SerializationManager::ELEMENT_TYPE::GAME_OBJECT;
-    }
+        LOG_INFO("Successfully saved file: {0}", path.c_str());
 
-    void SerializationManager::serialize_scene_data(Scene *scene, std::uint16_t number, std::ofstream &output)
-    {
-        output << "--- !u!" << m_element_to_id.at(ELEMENT_TYPE::SCENE) << " ";
-        output << "&" << number << '\n';
-        output << "Scene:\n";
-        output << m_default_offset << "m_Name: " << scene->get_name() << '\n';
+        return true;
     }
 
-    void SerializationManager::deserialize_scene_data(Scene* scene, std::ifstream& input)
+    Scene *SerializationManager::deserialize_scene_binary(const std::string &path)
     {
+        std::ifstream file(path, std::ios::binary);
 
-    }
+        if(!file.is_open())
+        {
+            LOG_ERROR("Failed to open file for deserialization: {0}", path.c_str());
+            return nullptr;
+        }
 
-    void SerializationManager::serialize_transform_component(const Transform &transform, std::ofstream &output)
-    {
-        output << m_default_offset << "Transform:\n";
-        output << m_component_prefix << "m_Position: { " << transform.m_position.x << " , " << transform.m_position.y << " , " << transform.m_position.z << " }\n";
-        output << m_component_prefix << "m_Rotation: { " << transform.m_rotation.x << " , " << transform.m_rotation.y << " , " << transform.m_rotation.z << " }\n";
-        output << m_component_prefix << "m_Scale: { " << transform.m_scale.x << " , " << transform.m_scale.y << " , " << transform.m_scale.z << " }\n";
+        char magic[sizeof(BINARY_MAGIC)];
+        std::uint32_t version;
+        if(!file.read(magic, sizeof(magic)) || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0 || !read_value(file, version) || version != m_binary_version)
+        {
+            LOG_ERROR("File: {0} is not a scene of binary version {1}", path.c_str(), m_binary_version);
+            return nullptr;
+        }
+
+        std::string scene_name;
+        std::uint32_t entity_count;
+        if(!read_string(file, scene_name) || !read_value(file, entity_count) || entity_count > MAX_ENTITIES)
+        {
+            LOG_ERROR("Corrupted scene file: {0}", path.c_str());
+            return nullptr;
+        }
+
+        auto main_manager = MainManager::get_instance();
+        std::vector<EntityID> entities = main_manager->create_entities(entity_count);
+        bool valid = true;
+
+        std::string name;
+        for(size_t i = 0; i < entities.size() && valid; i++)
+        {
+            std::uint8_t type;
+            valid = read_string(file, name) && read_value(file, type);
+            main_manager->set_entity_name(entities[i], name);
+            main_manager->set_entity_type(entities[i], static_cast<EntityType>(type));
+        }
+
+        std::uint32_t block_count = 0;
+        valid = valid && read_value(file, block_count);
+
+        for(std::uint32_t block = 0; block < block_count && valid; block++)
+        {
+            valid = deserialize_component_block(entities, file);
+        }
+
+        if(!valid)
+        {
+            LOG_ERROR("Corrupted scene file: {0}", path.c_str());
+
+            for(EntityID id : entities)
+            {
+                main_manager->destroy_entity(id);
+            }
+
+            return nullptr;
+        }
+
+        LOG_INFO("Successfully loaded file: {0}", path.c_str());
+
+        return new Scene(scene_name, std::set<EntityID>(entities.begin(), entities.end()));
     }
 
-    void SerializationManager::deserialize_transform_component()
+    SerializationManager::ComponentTable SerializationManager::collect_components(const std::vector<EntityID>& entities)
     {
+        auto main_manager = MainManager::get_instance();
+        ComponentTable table(main_manager->get_reflection_registry().get_type_count());
 
+        for(size_t type = 0; type < table.size(); type++)
+        {
+            const TypeInfo* info = main_manager->get_type_info(static_cast<ComponentType>(type));
+            if(!info)
+            {
+                continue;
+            }
+
+            std::vector<const std::byte*>& column = table[type];
+            column.assign(entities.size(), nullptr);
+
+            main_manager->each_component_run(info->m_component_type, [&](const EntityID* run, size_t count, const void* data) {
+                std::uint32_t hint = 0;
+
+                for(size_t i = 0; i < count; i++)
+                {
+                    std::uint32_t index = find_entity(entities, run[i], hint);
+                    if(index != INVALID_INDEX)
+                    {
+                        column[index] = static_cast<const std::byte*>(data) + i * info->m_size;
+                    }
+                }
+            });
+        }
+
+        return table;
     }
 
-    void SerializationManager::serialize_color_component(const Color &color, std::ofstream &output)
+    void SerializationManager::serialize_entity_info(std::uint32_t number, std::uint32_t index, const std::vector<EntityID>& entities, const ComponentTable& components, std::ofstream& output)
     {
-        output << m_default_offset << "Color:\n";
-        output << m_component_prefix << "m_Color: { " << color.m_color.x << " , " << color.m_color.y << " , " << color.m_color.z << " }\n";
+        auto main_manager = MainManager::get_instance();
+        EntityID entity_id = entities[index];
+
+        output << "--- !u!" << m_element_to_id.at(ELEMENT_TYPE::GAME_OBJECT) << " ";
+        output << "&" << number << '\n';
+        output << "GameObject:\n";
+        output << m_default_offset << "m_Name: " << main_manager->get_entity_name(entity_id) << '\n';
+        output << m_default_offset << "m_Type: " << static_cast<int>(main_manager->get_entity(entity_id).get_type()) << '\n';
+
+        for(size_t type = 0; type < components.size(); type++)
+        {
+            if(!components[type].empty() && components[type][index])
+            {
+                serialize_component(*main_manager->get_type_info(static_cast<ComponentType>(type)), components[type][index], entities, output);
+            }
+        }
     }
 
-    void SerializationManager::deserialize_color_component()
+    void SerializationManager::serialize_component(const TypeInfo& type, const std::byte* data, const std::vector<EntityID>& entities, std::ofstream& output)
     {
+        output << m_default_offset << type.m_name << ":\n";
 
+        for(const FieldInfo& field : type.m_fields)
+        {
+            output << m_component_prefix << field.m_name << ": ";
+            write_text_field(field, data, entities, output);
+            output << '\n';
+        }
     }
 
-    void SerializationManager::serialize_mesh_component(const MeshComponent &mesh, std::ofstream &output)
+    void SerializationManager::serialize_scene_data(Scene *scene, std::uint32_t number, std::ofstream &output)
     {
-        output << m_default_offset << "Mesh:\n";
-        output << m_component_prefix << "m_ID: " << mesh.m_id << '\n';
+        output << "--- !u!" << m_element_to_id.at(ELEMENT_TYPE::SCENE) << " ";
+        output << "&" << number << '\n';
+        output << "Scene:\n";
+        output << m_default_offset << "m_Name: " << scene->get_name() << '\n';
     }
 
-    void SerializationManager::deserialize_mesh_component()
+    //Block layout: type name, size, raw flag, field descriptions, component count, positions of the owners in the
+    //scene and the payload. Raw payloads are the components as laid out in memory, the others hold only the fields.
+    void SerializationManager::serialize_component_block(const TypeInfo& type, const std::vector<EntityID>& entities, std::ofstream& output)
     {
+        std::vector<std::uint32_t> elements;
+        std::vector<std::pair<const std::byte*, size_t>> segments;
+
+        //Consecutive components owned by scene entities are written with a single call.
+        MainManager::get_instance()->each_component_run(type.m_component_type, [&](const EntityID* run, size_t count, const void* data) {
+            auto* components = static_cast<const std::byte*>(data);
+            std::uint32_t hint = 0;
+
+            for(size_t i = 0; i < count; i++)
+            {
+                std::uint32_t index = find_entity(entities, run[i], hint);
+                if(index == INVALID_INDEX)
+                {
+                    continue;
+                }
+
+                const std::byte* component = components + i * type.m_size;
+                elements.push_back(index);
+
+                if(!segments.empty() && segments.back().first + segments.back().second * type.m_size == component)
+                {
+                    segments.back().second++;
+                }
+                else
+                {
+                    segments.emplace_back(component, 1);
+                }
+            }
+        });
+
+        write_string(output, type.m_name);
+        write_value(output, type.m_size);
+        write_value(output, static_cast<std::uint8_t>(type.m_trivially_copyable));
+        write_value(output, static_cast<std::uint32_t>(type.m_fields.size()));
+
+        for(const FieldInfo& field : type.m_fields)
+        {
+            write_string(output, field.m_name);
+            write_value(output, static_cast<std::uint8_t>(field.m_type));
+            write_value(output, field.m_offset);
+        }
 
-    }
+        write_value(output, static_cast<std::uint32_t>(elements.size()));
+        output.write(reinterpret_cast<const char*>(elements.data()), static_cast<std::streamsize>(elements.size() * sizeof(std::uint32_t)));
 
-    void SerializationManager::serialize_scene_camera_component(SceneCamera &scene_camera, std::ofstream &output)
-    {
-        output << m_default_offset << "SceneCamera:\n";
-        output << m_component_prefix << "m_UseSkybox: " << scene_camera.get_use_skybox() << '\n';
-        output << m_component_prefix << "m_PerspectiveView: " << scene_camera.get_use_perspective_view() << '\n';
-        output << m_component_prefix << "m_FOV: " << scene_camera.get_fov() << '\n';
-        output << m_component_prefix << "m_zNear: " << scene_camera.get_z_near() << '\n';
-        output << m_component_prefix << "m_zFar: " << scene_camera.get_z_far() << '\n';
-
-        auto& clear_color = scene_camera.get_clear_color();
-        output << m_component_prefix << "m_ClearColor: { " << clear_color[0] << " , " << clear_color[1] << " , " << clear_color[2] << " }\n";
+        std::vector<std::byte> scratch;
+        for(const auto& [components, count] : segments)
+        {
+            if(type.m_trivially_copyable && !type.m_has_entity_fields)
+            {
+                output.write(reinterpret_cast<const char*>(components), static_cast<std::streamsize>(count * type.m_size));
+                continue;
+            }
+
+            scratch.assign(components, components + count * type.m_size);
+            if(type.m_has_entity_fields)
+            {
+                for(size_t i = 0; i < count; i++)
+                {
+                    entity_fields_to_indices(type, scratch.data() + i * type.m_size, entities);
+                }
+            }
+
+            if(type.m_trivially_copyable)
+            {
+                output.write(reinterpret_cast<const char*>(scratch.data()), static_cast<std::streamsize>(scratch.size()));
+                continue;
+            }
+
+            for(size_t i = 0; i < count; i++)
+            {
+                for(const FieldInfo& field : type.m_fields)
+                {
+                    output.write(reinterpret_cast<const char*>(scratch.data() + i * type.m_size + field.m_offset), static_cast<std::streamsize>(get_field_size(field.m_type)));
+                }
+            }
+        }
     }
 
-    void SerializationManager::deserialize_scene_camera_component()
+    //Blocks whose layout matches the registered type are read straight into the components, the others field by
+    //field, matching fields by name and type. Blocks of unknown types are skipped.
+    bool SerializationManager::deserialize_component_block(const std::vector<EntityID>& entities, std::ifstream& input)
     {
+        std::string name;
+        std::uint32_t size, field_count, count;
+        std::uint8_t raw;
+
+        if(!read_string(input, name) || !read_value(input, size) || !read_value(input, raw) || !read_value(input, field_count) || field_count > UINT8_MAX)
+        {
+            return false;
+        }
+
+        std::vector<FieldInfo> fields(field_count);
+        std::vector<std::string> field_names(field_count);
+        std::uint32_t element_size = raw ? size : 0;
+
+        for(std::uint32_t i = 0; i < field_count; i++)
+        {
+            std::uint8_t field_type;
+            if(!read_string(input, field_names[i]) || !read_value(input, field_type) || !read_value(input, fields[i].m_offset) || field_type > static_cast<std::uint8_t>(FieldType::ENTITY))
+            {
+                return false;
+            }
+
+            fields[i].m_type = static_cast<FieldType>(field_type);
+            fields[i].m_name = field_names[i];
+
+            if(!raw)
+            {
+                fields[i].m_offset = element_size;
+                element_size += static_cast<std::uint32_t>(get_field_size(fields[i].m_type));
+            }
+            else if(fields[i].m_offset + get_field_size(fields[i].m_type) > size)
+            {
+                return false;
+            }
+        }
+
+        if(!read_value(input, count) || count > entities.size())
+        {
+            return false;
+        }
+
+        std::vector<std::uint32_t> elements(count);
+        if(!input.read(reinterpret_cast<char*>(elements.data()), static_cast<std::streamsize>(count * sizeof(std::uint32_t))))
+        {
+            return false;
+        }
+
+        if(std::any_of(elements.begin(), elements.end(), [&entities](std::uint32_t element) { return element >= entities.size(); }))
+        {
+            return false;
+        }
+
+        const TypeInfo* type = MainManager::get_instance()->get_reflection_registry().find_type(name);
+        if(!type)
+        {
+            LOG_WARNING("Skipping unknown component: {0}", name.c_str());
+            return static_cast<bool>(input.seekg(static_cast<std::streamoff>(count) * element_size, std::ios::cur));
+        }
+
+        bool same_layout = raw && type->m_trivially_copyable && size == type->m_size && fields.size() == type->m_fields.size() &&
+            std::equal(fields.begin(), fields.end(), type->m_fields.begin(), [](const FieldInfo& lhs, const FieldInfo& rhs) {
+                return lhs.m_name == rhs.m_name && lhs.m_type == rhs.m_type && lhs.m_offset == rhs.m_offset;
+            });
+
+        ComponentBuffer buffer(*type, count);
 
+        if(same_layout)
+        {
+            input.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(count) * size);
+        }
+        else
+        {
+            std::vector<const FieldInfo*> targets(fields.size());
+            for(size_t i = 0; i < fields.size(); i++)
+            {
+                targets[i] = type->find_field(fields[i].m_name);
+
+                if(!targets[i] || targets[i]->m_type != fields[i].m_type)
+                {
+                    LOG_WARNING("Skipping field: {0} of component: {1}", field_names[i].c_str(), name.c_str());
+                    targets[i] = nullptr;
+                }
+            }
+
+            std::vector<std::byte> element(element_size);
+            for(std::uint32_t i = 0; i < count && input.read(reinterpret_cast<char*>(element.data()), element_size); i++)
+            {
+                reset_entity_fields(*type, buffer.get(i));
+
+                for(size_t field = 0; field < fields.size(); field++)
+                {
+                    if(targets[field])
+                    {
+                        std::memcpy(buffer.get(i) + targets[field]->m_offset, element.data() + fields[field].m_offset, get_field_size(fields[field].m_type));
+                    }
+                }
+            }
+        }
+
+        if(!input)
+        {
+            return false;
+        }
+
+        add_loaded_components(*type, buffer, elements, entities);
+
+        return true;
     }
-}
\ No newline at end of file
+}
@@ -5,15 +5,21 @@
 #ifndef MAIN_SERIALIZATIONMANAGER_H
 #define MAIN_SERIALIZATIONMANAGER_H
 
+#include <vector>
+#include <cstddef>
 #include <unordered_map>
 
 #include "Manager.h"
 #include "../scene/Scene.h"
+#include "ecs/Reflection.h"
 #include "ecs/components/BasicComponents.h"
 #include "ecs/components/SceneCamera.h"
 
 namespace vis
 {
+    //Components are written through the ReflectionRegistry, every component with a Reflect specialization
+    //is saved and loaded without code of its own. The text format is human readable, the binary one copies
+    //trivially copyable component arrays as they are laid out in memory.
     class SerializationManager : public Manager
     {
     public:
@@ -23,6 +29,10 @@ namespace vis
 
         bool   serialize_scene(Scene* scene, const std::string& path);
         Scene* deserialize_scene(const std::string& path);
+
+        //Binary files use native byte order and are meant for fast saves and loads on the same platform.
+        bool   serialize_scene_binary(Scene* scene, const std::string& path);
+        Scene* deserialize_scene_binary(const std::string& path);
     private:
         enum class ELEMENT_TYPE
         {
@@ -30,31 +40,27 @@ namespace vis
             GAME_OBJECT,
             UNDEFINED
         };
+
+        //Pointers to components of scene entities, indexed by component type and then by position of the entity
+        //in the scene. Types without reflection data have no column.
+        using ComponentTable = std::vector<std::vector<const std::byte*>>;
     private:
         SerializationManager() = default;
         ~SerializationManager() override = default;
 
-        void         serialize_entity_info(std::uint16_t number, std::uint16_t entity_id, std::ofstream& output);
-        ELEMENT_TYPE deserialize_entity_info(std::string line);
-
-        void serialize_transform_component(const Transform& transform, std::ofstream& output);
-        void deserialize_transform_component();
-
-        void serialize_color_component(const Color& color, std::ofstream& output);
-        void deserialize_color_component();
-
-        void serialize_mesh_component(const MeshComponent& mesh, std::ofstream& output);
-        void deserialize_mesh_component();
+        ComponentTable collect_components(const std::vector<EntityID>& entities);
 
-        void serialize_scene_camera_component(SceneCamera& scene_camera, std::ofstream& output);
-        void deserialize_scene_camera_component();
+        void serialize_entity_info(std::uint32_t number, std::uint32_t index, const std::vector<EntityID>& entities, const ComponentTable& components, std::ofstream& output);
+        void serialize_component(const TypeInfo& type, const std::byte* data, const std::vector<EntityID>& entities, std::ofstream& output);
+        void serialize_scene_data(Scene* scene, std::uint32_t number, std::ofstream& output);
 
-        void serialize_scene_data(Scene* scene, std::uint16_t number, std::ofstream& output);
-        void deserialize_scene_data(Scene* scene, std::ifstream& input);
+        void serialize_component_block(const TypeInfo& type, const std::vector<EntityID>& entities, std::ofstream& output);
+        bool deserialize_component_block(const std::vector<EntityID>& entities, std::ifstream& input);
     private:
         std::unordered_map<ELEMENT_TYPE, std::uint16_t> m_element_to_id;
         static SerializationManager* m_instance;
         static float                 m_version;
+        static std::uint32_t         m_binary_version;
         static std::string           m_component_prefix;
         static std::string           m_default_offset;
     };
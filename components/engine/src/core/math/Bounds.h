@@ -0,0 +1,26 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_BOUNDS_H
+#define MAIN_BOUNDS_H
+
+#include "glm/glm.hpp"
+
+namespace vis
+{
+    //Axis aligned box, both corners inclusive.
+    struct AABB
+    {
+        glm::vec3 m_min;
+        glm::vec3 m_max;
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 m_center;
+        float     m_radius;
+    };
+}
+
+#endif //MAIN_BOUNDS_H
@@ -0,0 +1,170 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "Frustum.h"
+
+#include <bit>
+#include <cmath>
+#include <algorithm>
+
+#ifdef VIS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vis
+{
+    namespace
+    {
+        bool is_visible(const Frustum& a_frustum, const CullBounds& a_bounds, size_t a_index)
+        {
+            for(const glm::vec4& plane : a_frustum.m_planes)
+            {
+                float box_distance = plane.x * a_bounds.m_box_x[a_index] + plane.y * a_bounds.m_box_y[a_index] + plane.z * a_bounds.m_box_z[a_index] + plane.w;
+                float box_reach = std::abs(plane.x) * a_bounds.m_extent_x[a_index] + std::abs(plane.y) * a_bounds.m_extent_y[a_index] + std::abs(plane.z) * a_bounds.m_extent_z[a_index];
+                float sphere_distance = plane.x * a_bounds.m_sphere_x[a_index] + plane.y * a_bounds.m_sphere_y[a_index] + plane.z * a_bounds.m_sphere_z[a_index] + plane.w;
+
+                if(box_distance + box_reach < 0.0f || sphere_distance + a_bounds.m_radius[a_index] < 0.0f)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    //Gribb and Hartmann, planes are sums and differences of the fourth row with the other three.
+    Frustum make_frustum(const glm::mat4& a_view_projection)
+    {
+        glm::vec4 rows[4];
+        for(int row = 0; row < 4; row++)
+        {
+            rows[row] = glm::vec4(a_view_projection[0][row], a_view_projection[1][row], a_view_projection[2][row], a_view_projection[3][row]);
+        }
+
+        Frustum frustum{};
+        for(int axis = 0; axis < 3; axis++)
+        {
+            frustum.m_planes[2 * axis]     = rows[3] + rows[axis];
+            frustum.m_planes[2 * axis + 1] = rows[3] - rows[axis];
+        }
+
+        for(glm::vec4& plane : frustum.m_planes)
+        {
+            float length = glm::length(glm::vec3(plane));
+
+            if(length > 0.0f)
+            {
+                plane /= length;
+            }
+        }
+
+        return frustum;
+    }
+
+    void CullBounds::push(const AABB& a_box, const BoundingSphere& a_sphere, const glm::mat4& a_model)
+    {
+        glm::mat3 linear(a_model);
+        glm::mat3 absolute(glm::abs(linear[0]), glm::abs(linear[1]), glm::abs(linear[2]));
+
+        glm::vec3 box_center = glm::vec3(a_model * glm::vec4((a_box.m_min + a_box.m_max) * 0.5f, 1.0f));
+        glm::vec3 box_extent = absolute * ((a_box.m_max - a_box.m_min) * 0.5f);
+        glm::vec3 sphere_center = glm::vec3(a_model * glm::vec4(a_sphere.m_center, 1.0f));
+        float scale = std::max({ glm::length(linear[0]), glm::length(linear[1]), glm::length(linear[2]) });
+
+        m_box_x.push_back(box_center.x);
+        m_box_y.push_back(box_center.y);
+        m_box_z.push_back(box_center.z);
+        m_extent_x.push_back(box_extent.x);
+        m_extent_y.push_back(box_extent.y);
+        m_extent_z.push_back(box_extent.z);
+        m_sphere_x.push_back(sphere_center.x);
+        m_sphere_y.push_back(sphere_center.y);
+        m_sphere_z.push_back(sphere_center.z);
+        m_radius.push_back(a_sphere.m_radius * scale);
+    }
+
+    void CullBounds::clear()
+    {
+        for(std::vector<float>* array : { &m_box_x, &m_box_y, &m_box_z, &m_extent_x, &m_extent_y, &m_extent_z, &m_sphere_x, &m_sphere_y, &m_sphere_z, &m_radius })
+        {
+            array->clear();
+        }
+    }
+
+    size_t CullBounds::size() const
+    {
+        return m_radius.size();
+    }
+
+    size_t cull_bounds(const Frustum& a_frustum, const CullBounds& a_bounds, std::uint32_t* a_visible)
+    {
+        size_t count = a_bounds.size();
+        size_t visible = 0;
+        size_t i = 0;
+
+#ifdef VIS_SIMD_SSE2
+        __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        __m128 plane_x[FRUSTUM_PLANES_COUNT], plane_y[FRUSTUM_PLANES_COUNT], plane_z[FRUSTUM_PLANES_COUNT], plane_w[FRUSTUM_PLANES_COUNT];
+        __m128 abs_x[FRUSTUM_PLANES_COUNT], abs_y[FRUSTUM_PLANES_COUNT], abs_z[FRUSTUM_PLANES_COUNT];
+
+        for(int plane = 0; plane < FRUSTUM_PLANES_COUNT; plane++)
+        {
+            plane_x[plane] = _mm_set1_ps(a_frustum.m_planes[plane].x);
+            plane_y[plane] = _mm_set1_ps(a_frustum.m_planes[plane].y);
+            plane_z[plane] = _mm_set1_ps(a_frustum.m_planes[plane].z);
+            plane_w[plane] = _mm_set1_ps(a_frustum.m_planes[plane].w);
+            abs_x[plane] = _mm_and_ps(plane_x[plane], sign_mask);
+            abs_y[plane] = _mm_and_ps(plane_y[plane], sign_mask);
+            abs_z[plane] = _mm_and_ps(plane_z[plane], sign_mask);
+        }
+
+        __m128 zero = _mm_setzero_ps();
+        for(; i + 4 <= count; i += 4)
+        {
+            __m128 box_x = _mm_loadu_ps(&a_bounds.m_box_x[i]);
+            __m128 box_y = _mm_loadu_ps(&a_bounds.m_box_y[i]);
+            __m128 box_z = _mm_loadu_ps(&a_bounds.m_box_z[i]);
+            __m128 extent_x = _mm_loadu_ps(&a_bounds.m_extent_x[i]);
+            __m128 extent_y = _mm_loadu_ps(&a_bounds.m_extent_y[i]);
+            __m128 extent_z = _mm_loadu_ps(&a_bounds.m_extent_z[i]);
+            __m128 sphere_x = _mm_loadu_ps(&a_bounds.m_sphere_x[i]);
+            __m128 sphere_y = _mm_loadu_ps(&a_bounds.m_sphere_y[i]);
+            __m128 sphere_z = _mm_loadu_ps(&a_bounds.m_sphere_z[i]);
+            __m128 radius = _mm_loadu_ps(&a_bounds.m_radius[i]);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for(int plane = 0; plane < FRUSTUM_PLANES_COUNT; plane++)
+            {
+                __m128 box_distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane_x[plane], box_x), _mm_mul_ps(plane_y[plane], box_y)),
+                                                 _mm_add_ps(_mm_mul_ps(plane_z[plane], box_z), plane_w[plane]));
+                __m128 box_reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(abs_x[plane], extent_x), _mm_mul_ps(abs_y[plane], extent_y)),
+                                              _mm_mul_ps(abs_z[plane], extent_z));
+                __m128 sphere_distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane_x[plane], sphere_x), _mm_mul_ps(plane_y[plane], sphere_y)),
+                                                    _mm_add_ps(_mm_mul_ps(plane_z[plane], sphere_z), plane_w[plane]));
+
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(box_distance, box_reach), zero));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(sphere_distance, radius), zero));
+            }
+
+            auto mask = static_cast<unsigned int>(_mm_movemask_ps(inside));
+            while(mask)
+            {
+                a_visible[visible++] = static_cast<std::uint32_t>(i + std::countr_zero(mask));
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        for(; i < count; i++)
+        {
+            if(is_visible(a_frustum, a_bounds, i))
+            {
+                a_visible[visible++] = static_cast<std::uint32_t>(i);
+            }
+        }
+
+        return visible;
+    }
+}
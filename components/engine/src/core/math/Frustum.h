@@ -0,0 +1,56 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_FRUSTUM_H
+#define MAIN_FRUSTUM_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Simd.h"
+#include "Bounds.h"
+#include "glm/glm.hpp"
+
+#define FRUSTUM_PLANES_COUNT 6
+
+namespace vis
+{
+    //Planes as (normal, distance) with normals pointing inside, a point p is inside a plane when dot(normal, p) + distance >= 0.
+    struct Frustum
+    {
+        glm::vec4 m_planes[FRUSTUM_PLANES_COUNT];
+    };
+
+    //Left, right, bottom, top, near and far plane of a_view_projection, usually projection * view of a camera.
+    Frustum make_frustum(const glm::mat4& a_view_projection);
+
+    //World space bounds of objects to cull, one element per object in structure of arrays layout so cull_bounds
+    //can load four objects per register.
+    struct CullBounds
+    {
+        std::vector<float> m_box_x;
+        std::vector<float> m_box_y;
+        std::vector<float> m_box_z;
+        std::vector<float> m_extent_x;
+        std::vector<float> m_extent_y;
+        std::vector<float> m_extent_z;
+        std::vector<float> m_sphere_x;
+        std::vector<float> m_sphere_y;
+        std::vector<float> m_sphere_z;
+        std::vector<float> m_radius;
+
+        //Appends model space a_box and a_sphere moved to world space by a_model. The box stays axis aligned and grows
+        //to contain the rotated one, the sphere radius is scaled by the largest axis scale of a_model.
+        void push(const AABB& a_box, const BoundingSphere& a_sphere, const glm::mat4& a_model);
+        void clear();
+        size_t size() const;
+    };
+
+    //Writes indices of objects whose box and sphere both touch a_frustum to a_visible in increasing order and returns
+    //their count, a_visible must have room for a_bounds.size() indices. Four objects at a time with SSE2 when available.
+    size_t cull_bounds(const Frustum& a_frustum, const CullBounds& a_bounds, std::uint32_t* a_visible);
+}
+
+#endif //MAIN_FRUSTUM_H
@@ -0,0 +1,13 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_SIMD_H
+#define MAIN_SIMD_H
+
+//Instruction sets kernels may use, every kernel keeps a scalar path for targets without them.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VIS_SIMD_SSE2
+#endif
+
+#endif //MAIN_SIMD_H
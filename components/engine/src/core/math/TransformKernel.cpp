@@ -0,0 +1,154 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "TransformKernel.h"
+
+#include <cmath>
+
+#ifdef VIS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vis
+{
+    namespace
+    {
+        constexpr float DEGREES_TO_RADIANS = 0.017453292519943295f;
+
+        //Columns of the rotation part only, c = cos, s = sin of the angle around each axis.
+        void compose_scalar(const Transform& a_transform, glm::mat4& a_out)
+        {
+            glm::vec3 angles = a_transform.m_rotation * DEGREES_TO_RADIANS;
+            float cx = std::cos(angles.x), sx = std::sin(angles.x);
+            float cy = std::cos(angles.y), sy = std::sin(angles.y);
+            float cz = std::cos(angles.z), sz = std::sin(angles.z);
+            float sxsy = sx * sy, cxsy = cx * sy;
+            const glm::vec3& scale = a_transform.m_scale;
+
+            a_out[0] = glm::vec4(cy * cz, sxsy * cz + cx * sz, sx * sz - cxsy * cz, 0.0f) * scale.x;
+            a_out[1] = glm::vec4(-cy * sz, cx * cz - sxsy * sz, cxsy * sz + sx * cz, 0.0f) * scale.y;
+            a_out[2] = glm::vec4(sy, -sx * cy, cx * cy, 0.0f) * scale.z;
+            a_out[3] = glm::vec4(a_transform.m_position, 1.0f);
+        }
+
+#ifdef VIS_SIMD_SSE2
+        //Cody-Waite reduction to [-pi/4, pi/4] around the nearest multiple of pi/2, then the cephes minimax
+        //polynomials. The quadrant picks which polynomial goes where and with which sign.
+        void sincos_ps(__m128 a_x, __m128& a_sin, __m128& a_cos)
+        {
+            __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(a_x, _mm_set1_ps(0.63661977236758134f)));
+            __m128 q = _mm_cvtepi32_ps(quadrant);
+
+            __m128 r = _mm_sub_ps(a_x, _mm_mul_ps(q, _mm_set1_ps(1.5703125f)));
+            r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(4.837512969970703125e-4f)));
+            r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(7.54978995489188216e-8f)));
+            __m128 r2 = _mm_mul_ps(r, r);
+
+            __m128 sin_poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), r2), _mm_set1_ps(8.3321608736e-3f));
+            sin_poly = _mm_add_ps(_mm_mul_ps(sin_poly, r2), _mm_set1_ps(-1.6666654611e-1f));
+            sin_poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sin_poly, r2), r), r);
+
+            __m128 cos_poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), r2), _mm_set1_ps(-1.388731625493765e-3f));
+            cos_poly = _mm_add_ps(_mm_mul_ps(cos_poly, r2), _mm_set1_ps(4.166664568298827e-2f));
+            cos_poly = _mm_mul_ps(_mm_mul_ps(cos_poly, r2), r2);
+            cos_poly = _mm_add_ps(_mm_sub_ps(cos_poly, _mm_mul_ps(r2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+            __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+            __m128 sin_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+            __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+            a_sin = _mm_or_ps(_mm_and_ps(swap, cos_poly), _mm_andnot_ps(swap, sin_poly));
+            a_cos = _mm_or_ps(_mm_and_ps(swap, sin_poly), _mm_andnot_ps(swap, cos_poly));
+            a_sin = _mm_xor_ps(a_sin, sin_sign);
+            a_cos = _mm_xor_ps(a_cos, cos_sign);
+        }
+
+        //Same formula as compose_scalar, lane i of every register belongs to a_transforms[i].
+        void compose_sse2(const Transform* a_transforms, glm::mat4* a_out)
+        {
+            const Transform* t = a_transforms;
+            auto gather = [t](auto a_member, int a_component) {
+                return _mm_setr_ps((t[0].*a_member)[a_component], (t[1].*a_member)[a_component],
+                                   (t[2].*a_member)[a_component], (t[3].*a_member)[a_component]);
+            };
+
+            __m128 to_radians = _mm_set1_ps(DEGREES_TO_RADIANS);
+            __m128 sx, cx, sy, cy, sz, cz;
+            sincos_ps(_mm_mul_ps(gather(&Transform::m_rotation, 0), to_radians), sx, cx);
+            sincos_ps(_mm_mul_ps(gather(&Transform::m_rotation, 1), to_radians), sy, cy);
+            sincos_ps(_mm_mul_ps(gather(&Transform::m_rotation, 2), to_radians), sz, cz);
+
+            __m128 scale_x = gather(&Transform::m_scale, 0);
+            __m128 scale_y = gather(&Transform::m_scale, 1);
+            __m128 scale_z = gather(&Transform::m_scale, 2);
+            __m128 sxsy = _mm_mul_ps(sx, sy);
+            __m128 cxsy = _mm_mul_ps(cx, sy);
+            __m128 zero = _mm_setzero_ps();
+
+            __m128 columns[4][4] = {
+                {
+                    _mm_mul_ps(_mm_mul_ps(cy, cz), scale_x),
+                    _mm_mul_ps(_mm_add_ps(_mm_mul_ps(sxsy, cz), _mm_mul_ps(cx, sz)), scale_x),
+                    _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sx, sz), _mm_mul_ps(cxsy, cz)), scale_x),
+                    zero
+                },
+                {
+                    _mm_mul_ps(_mm_sub_ps(zero, _mm_mul_ps(cy, sz)), scale_y),
+                    _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(cx, cz), _mm_mul_ps(sxsy, sz)), scale_y),
+                    _mm_mul_ps(_mm_add_ps(_mm_mul_ps(cxsy, sz), _mm_mul_ps(sx, cz)), scale_y),
+                    zero
+                },
+                {
+                    _mm_mul_ps(sy, scale_z),
+                    _mm_mul_ps(_mm_sub_ps(zero, _mm_mul_ps(sx, cy)), scale_z),
+                    _mm_mul_ps(_mm_mul_ps(cx, cy), scale_z),
+                    zero
+                },
+                {
+                    gather(&Transform::m_position, 0),
+                    gather(&Transform::m_position, 1),
+                    gather(&Transform::m_position, 2),
+                    _mm_set1_ps(1.0f)
+                }
+            };
+
+            for(int column = 0; column < 4; column++)
+            {
+                __m128* rows = columns[column];
+                _MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+
+                for(int lane = 0; lane < 4; lane++)
+                {
+                    _mm_storeu_ps(&a_out[lane][column].x, rows[lane]);
+                }
+            }
+        }
+#endif
+    }
+
+    void compose_model_matrices(const Transform* a_transforms, size_t a_count, glm::mat4* a_out)
+    {
+        size_t i = 0;
+
+#ifdef VIS_SIMD_SSE2
+        for(; i + 4 <= a_count; i += 4)
+        {
+            compose_sse2(a_transforms + i, a_out + i);
+        }
+#endif
+
+        for(; i < a_count; i++)
+        {
+            compose_scalar(a_transforms[i], a_out[i]);
+        }
+    }
+
+    glm::mat4 compose_model_matrix(const Transform& a_transform)
+    {
+        glm::mat4 result;
+        compose_scalar(a_transform, result);
+
+        return result;
+    }
+}
@@ -0,0 +1,24 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_TRANSFORMKERNEL_H
+#define MAIN_TRANSFORMKERNEL_H
+
+#include <cstddef>
+
+#include "Simd.h"
+#include "glm/glm.hpp"
+#include "ecs/components/BasicComponents.h"
+
+namespace vis
+{
+    //Writes translate * rotate_x * rotate_y * rotate_z * scale of a_transforms[i] (rotation in degrees) to a_out[i],
+    //the same matrix the glm translate / rotate / scale chain builds. Rotation is composed directly from sines and
+    //cosines of the three angles, four transforms at a time with SSE2 when available.
+    void compose_model_matrices(const Transform* a_transforms, size_t a_count, glm::mat4* a_out);
+
+    glm::mat4 compose_model_matrix(const Transform& a_transform);
+}
+
+#endif //MAIN_TRANSFORMKERNEL_H
@@ -0,0 +1,270 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "BodyIntegrator.h"
+
+#include <bit>
+#include <cmath>
+#include <utility>
+
+#ifdef VIS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vis
+{
+    namespace
+    {
+        constexpr std::uint32_t INVALID_SLOT = UINT32_MAX;
+    }
+
+    BodyIntegrator::BodyIntegrator()
+    {
+        m_awake_count = 0;
+        m_integrated_count = 0;
+        m_acceleration = glm::vec3(0.0f);
+        m_damping = 0.0f;
+        m_sleep_velocity = BODY_DEFAULT_SLEEP_VELOCITY;
+        m_sleep_time = BODY_DEFAULT_SLEEP_TIME;
+    }
+
+    void BodyIntegrator::update(EntityID a_id, const glm::vec3& a_position, const glm::vec3& a_velocity)
+    {
+        std::uint32_t index = get_entity_index(a_id);
+        if(index >= m_slots.size())
+        {
+            m_slots.resize(index + 1, INVALID_SLOT);
+        }
+
+        std::uint32_t slot = m_slots[index];
+        if(slot == INVALID_SLOT)
+        {
+            slot = static_cast<std::uint32_t>(m_entities.size());
+
+            for(std::vector<float>* array : { &m_position_x, &m_position_y, &m_position_z, &m_velocity_x, &m_velocity_y, &m_velocity_z, &m_slow_time })
+            {
+                array->push_back(0.0f);
+            }
+
+            m_entities.push_back(a_id);
+            m_slots[index] = slot;
+        }
+
+        m_entities[slot] = a_id;
+        m_position_x[slot] = a_position.x;
+        m_position_y[slot] = a_position.y;
+        m_position_z[slot] = a_position.z;
+        m_velocity_x[slot] = a_velocity.x;
+        m_velocity_y[slot] = a_velocity.y;
+        m_velocity_z[slot] = a_velocity.z;
+        m_slow_time[slot] = 0.0f;
+
+        wake_slot(slot);
+    }
+
+    void BodyIntegrator::remove(EntityID a_id)
+    {
+        if(!contains(a_id))
+        {
+            return;
+        }
+
+        std::uint32_t index = get_entity_index(a_id);
+        std::uint32_t slot = m_slots[index];
+
+        sleep_slot(slot);
+        slot = m_slots[index];
+
+        swap_slots(slot, static_cast<std::uint32_t>(m_entities.size() - 1));
+
+        for(std::vector<float>* array : { &m_position_x, &m_position_y, &m_position_z, &m_velocity_x, &m_velocity_y, &m_velocity_z, &m_slow_time })
+        {
+            array->pop_back();
+        }
+
+        m_entities.pop_back();
+        m_slots[index] = INVALID_SLOT;
+        m_integrated_count = 0;
+    }
+
+    void BodyIntegrator::wake(EntityID a_id)
+    {
+        if(contains(a_id))
+        {
+            std::uint32_t slot = m_slots[get_entity_index(a_id)];
+            m_slow_time[slot] = 0.0f;
+
+            wake_slot(slot);
+        }
+    }
+
+    bool BodyIntegrator::contains(EntityID a_id) const
+    {
+        std::uint32_t index = get_entity_index(a_id);
+
+        return index < m_slots.size() && m_slots[index] != INVALID_SLOT && m_entities[m_slots[index]] == a_id;
+    }
+
+    bool BodyIntegrator::is_sleeping(EntityID a_id) const
+    {
+        return contains(a_id) && m_slots[get_entity_index(a_id)] >= m_awake_count;
+    }
+
+    void BodyIntegrator::clear()
+    {
+        for(std::vector<float>* array : { &m_position_x, &m_position_y, &m_position_z, &m_velocity_x, &m_velocity_y, &m_velocity_z, &m_slow_time })
+        {
+            array->clear();
+        }
+
+        m_entities.clear();
+        m_slots.clear();
+        m_awake_count = 0;
+        m_integrated_count = 0;
+    }
+
+    size_t BodyIntegrator::size() const
+    {
+        return m_entities.size();
+    }
+
+    size_t BodyIntegrator::get_awake_count() const
+    {
+        return m_awake_count;
+    }
+
+    void BodyIntegrator::integrate(float a_dt)
+    {
+        float damping = std::exp(-m_damping * a_dt);
+        glm::vec3 velocity_step = m_acceleration * a_dt;
+        float sleep_velocity_squared = m_sleep_velocity * m_sleep_velocity;
+        size_t count = m_awake_count;
+        size_t i = 0;
+
+        m_falling_asleep.clear();
+
+#ifdef VIS_SIMD_SSE2
+        __m128 dt = _mm_set1_ps(a_dt);
+        __m128 damping_4 = _mm_set1_ps(damping);
+        __m128 step_x = _mm_set1_ps(velocity_step.x);
+        __m128 step_y = _mm_set1_ps(velocity_step.y);
+        __m128 step_z = _mm_set1_ps(velocity_step.z);
+        __m128 sleep_velocity_4 = _mm_set1_ps(sleep_velocity_squared);
+        __m128 sleep_time_4 = _mm_set1_ps(m_sleep_time);
+
+        for(; i + 4 <= count; i += 4)
+        {
+            __m128 velocity_x = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_velocity_x[i]), damping_4), step_x);
+            __m128 velocity_y = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_velocity_y[i]), damping_4), step_y);
+            __m128 velocity_z = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_velocity_z[i]), damping_4), step_z);
+
+            _mm_storeu_ps(&m_position_x[i], _mm_add_ps(_mm_loadu_ps(&m_position_x[i]), _mm_mul_ps(velocity_x, dt)));
+            _mm_storeu_ps(&m_position_y[i], _mm_add_ps(_mm_loadu_ps(&m_position_y[i]), _mm_mul_ps(velocity_y, dt)));
+            _mm_storeu_ps(&m_position_z[i], _mm_add_ps(_mm_loadu_ps(&m_position_z[i]), _mm_mul_ps(velocity_z, dt)));
+            _mm_storeu_ps(&m_velocity_x[i], velocity_x);
+            _mm_storeu_ps(&m_velocity_y[i], velocity_y);
+            _mm_storeu_ps(&m_velocity_z[i], velocity_z);
+
+            __m128 speed = _mm_add_ps(_mm_add_ps(_mm_mul_ps(velocity_x, velocity_x), _mm_mul_ps(velocity_y, velocity_y)), _mm_mul_ps(velocity_z, velocity_z));
+            __m128 slow_time = _mm_and_ps(_mm_add_ps(_mm_loadu_ps(&m_slow_time[i]), dt), _mm_cmplt_ps(speed, sleep_velocity_4));
+            _mm_storeu_ps(&m_slow_time[i], slow_time);
+
+            auto mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpge_ps(slow_time, sleep_time_4)));
+            while(mask)
+            {
+                m_falling_asleep.push_back(static_cast<std::uint32_t>(i + std::countr_zero(mask)));
+                mask &= mask - 1;
+            }
+        }
+#endif
+
+        for(; i < count; i++)
+        {
+            glm::vec3 velocity = glm::vec3(m_velocity_x[i], m_velocity_y[i], m_velocity_z[i]) * damping + velocity_step;
+
+            m_position_x[i] += velocity.x * a_dt;
+            m_position_y[i] += velocity.y * a_dt;
+            m_position_z[i] += velocity.z * a_dt;
+            m_velocity_x[i] = velocity.x;
+            m_velocity_y[i] = velocity.y;
+            m_velocity_z[i] = velocity.z;
+
+            m_slow_time[i] = glm::dot(velocity, velocity) < sleep_velocity_squared ? m_slow_time[i] + a_dt : 0.0f;
+            if(m_slow_time[i] >= m_sleep_time)
+            {
+                m_falling_asleep.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        //From the back, so every body swapped into a freed slot has been integrated and isn't falling asleep.
+        for(auto it = m_falling_asleep.rbegin(); it != m_falling_asleep.rend(); ++it)
+        {
+            m_velocity_x[*it] = 0.0f;
+            m_velocity_y[*it] = 0.0f;
+            m_velocity_z[*it] = 0.0f;
+
+            sleep_slot(*it);
+        }
+
+        m_integrated_count = count;
+    }
+
+    void BodyIntegrator::set_acceleration(const glm::vec3& a_acceleration)
+    {
+        m_acceleration = a_acceleration;
+    }
+
+    void BodyIntegrator::set_damping(float a_damping)
+    {
+        m_damping = a_damping;
+    }
+
+    void BodyIntegrator::set_sleep_threshold(float a_velocity, float a_time)
+    {
+        m_sleep_velocity = a_velocity;
+        m_sleep_time = a_time;
+    }
+
+    void BodyIntegrator::swap_slots(std::uint32_t a_first, std::uint32_t a_second)
+    {
+        if(a_first == a_second)
+        {
+            return;
+        }
+
+        for(std::vector<float>* array : { &m_position_x, &m_position_y, &m_position_z, &m_velocity_x, &m_velocity_y, &m_velocity_z, &m_slow_time })
+        {
+            std::swap((*array)[a_first], (*array)[a_second]);
+        }
+
+        std::swap(m_entities[a_first], m_entities[a_second]);
+        m_slots[get_entity_index(m_entities[a_first])] = a_first;
+        m_slots[get_entity_index(m_entities[a_second])] = a_second;
+    }
+
+    //Moves the body to the end of the awake range.
+    void BodyIntegrator::wake_slot(std::uint32_t a_slot)
+    {
+        if(a_slot < m_awake_count)
+        {
+            return;
+        }
+
+        swap_slots(a_slot, static_cast<std::uint32_t>(m_awake_count));
+        m_awake_count++;
+        m_integrated_count = 0;
+    }
+
+    //Moves the body to the front of the sleeping range.
+    void BodyIntegrator::sleep_slot(std::uint32_t a_slot)
+    {
+        if(a_slot >= m_awake_count)
+        {
+            return;
+        }
+
+        m_awake_count--;
+        swap_slots(a_slot, static_cast<std::uint32_t>(m_awake_count));
+    }
+}
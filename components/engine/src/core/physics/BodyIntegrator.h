@@ -0,0 +1,94 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_BODYINTEGRATOR_H
+#define MAIN_BODYINTEGRATOR_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Types.h"
+#include "math/Simd.h"
+#include "glm/glm.hpp"
+
+#define BODY_DEFAULT_SLEEP_VELOCITY 0.05f
+#define BODY_DEFAULT_SLEEP_TIME 0.5f
+
+namespace vis
+{
+    //Positions and velocities of bodies in structure of arrays layout, integrated four at a time with SSE2.
+    //Awake bodies are kept at the front of the arrays and only they are integrated. A body slower than the sleep
+    //velocity for the whole sleep time is moved behind them with its velocity zeroed, and stays there at no cost
+    //until it is woken, updated or removed.
+    class BodyIntegrator
+    {
+    public:
+        BodyIntegrator();
+
+        //Inserts a_id or overwrites its state, either way the body is awake afterwards.
+        void update(EntityID a_id, const glm::vec3& a_position, const glm::vec3& a_velocity);
+        void remove(EntityID a_id);
+        void wake(EntityID a_id);
+        bool contains(EntityID a_id) const;
+        bool is_sleeping(EntityID a_id) const;
+        void clear();
+
+        size_t size() const;
+        size_t get_awake_count() const;
+
+        //Semi implicit Euler, velocity gets a_dt of acceleration and damping first and then moves the position.
+        void integrate(float a_dt);
+
+        //Every body integrated by the last integrate, including ones it put to sleep, until the next change.
+        //a_func(EntityID, const glm::vec3& position, const glm::vec3& velocity).
+        template<typename F>
+        void for_each_integrated(F&& a_func) const;
+
+        //Same for every body.
+        void set_acceleration(const glm::vec3& a_acceleration);
+
+        //Fraction of velocity lost per second is 1 - exp(-a_damping), 0 keeps velocity as it is.
+        void set_damping(float a_damping);
+        void set_sleep_threshold(float a_velocity, float a_time);
+    private:
+        void swap_slots(std::uint32_t a_first, std::uint32_t a_second);
+        void wake_slot(std::uint32_t a_slot);
+        void sleep_slot(std::uint32_t a_slot);
+    private:
+        std::vector<float>         m_position_x;
+        std::vector<float>         m_position_y;
+        std::vector<float>         m_position_z;
+        std::vector<float>         m_velocity_x;
+        std::vector<float>         m_velocity_y;
+        std::vector<float>         m_velocity_z;
+        std::vector<float>         m_slow_time;
+        std::vector<EntityID>      m_entities;
+
+        //Slot of every entity index, stale handles are told apart through m_entities.
+        std::vector<std::uint32_t> m_slots;
+
+        //Slots falling asleep in the current integrate, in increasing order.
+        std::vector<std::uint32_t> m_falling_asleep;
+
+        size_t                     m_awake_count;
+        size_t                     m_integrated_count;
+        glm::vec3                  m_acceleration;
+        float                      m_damping;
+        float                      m_sleep_velocity;
+        float                      m_sleep_time;
+    };
+
+    template<typename F>
+    void BodyIntegrator::for_each_integrated(F&& a_func) const
+    {
+        for(size_t slot = 0; slot < m_integrated_count; slot++)
+        {
+            a_func(m_entities[slot],
+                   glm::vec3(m_position_x[slot], m_position_y[slot], m_position_z[slot]),
+                   glm::vec3(m_velocity_x[slot], m_velocity_y[slot], m_velocity_z[slot]));
+        }
+    }
+}
+
+#endif //MAIN_BODYINTEGRATOR_H
@@ -0,0 +1,374 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "SweepAndPrune.h"
+#include "TPool.h"
+
+#include <bit>
+#include <algorithm>
+
+#ifdef VIS_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace vis
+{
+    namespace
+    {
+        constexpr std::uint32_t INVALID_BODY = UINT32_MAX;
+
+        //Variance the best axis needs over the current one to switch, keeps the sort from flipping between two
+        //similar axes where every flip costs a full sort.
+        constexpr double AXIS_SWITCH_RATIO = 1.5;
+
+        //Bodies inserted since the last sort are appended at the end, once they are more than one in this many
+        //bodies a full sort is cheaper than moving each of them down.
+        constexpr size_t FULL_SORT_INSERTED_FRACTION = 8;
+
+        BroadphasePair make_pair(EntityID a_first, EntityID a_second)
+        {
+            return a_first < a_second ? BroadphasePair{ a_first, a_second } : BroadphasePair{ a_second, a_first };
+        }
+    }
+
+    SweepAndPrune::SweepAndPrune()
+    {
+        m_removed = 0;
+        m_inserted = 0;
+        m_axis = 0;
+    }
+
+    void SweepAndPrune::update(EntityID a_id, const AABB& a_box)
+    {
+        std::uint32_t index = get_entity_index(a_id);
+        if(index >= m_bodies.size())
+        {
+            m_bodies.resize(index + 1, INVALID_BODY);
+        }
+
+        std::uint32_t body = m_bodies[index];
+        if(body == INVALID_BODY)
+        {
+            body = static_cast<std::uint32_t>(m_entities.size());
+
+            for(int axis = 0; axis < 3; axis++)
+            {
+                m_min[axis].push_back(0.0f);
+                m_max[axis].push_back(0.0f);
+            }
+
+            m_entities.push_back(a_id);
+            m_ranks.push_back(static_cast<std::uint32_t>(m_order.size()));
+            m_order.push_back(body);
+            m_bodies[index] = body;
+            m_inserted++;
+        }
+
+        m_entities[body] = a_id;
+        for(int axis = 0; axis < 3; axis++)
+        {
+            m_min[axis][body] = a_box.m_min[axis];
+            m_max[axis][body] = a_box.m_max[axis];
+        }
+    }
+
+    //Last body is moved into the freed one, its place in the sweep order follows it.
+    void SweepAndPrune::remove(EntityID a_id)
+    {
+        if(!contains(a_id))
+        {
+            return;
+        }
+
+        std::uint32_t index = get_entity_index(a_id);
+        std::uint32_t body = m_bodies[index];
+        std::uint32_t last = static_cast<std::uint32_t>(m_entities.size() - 1);
+
+        m_order[m_ranks[body]] = INVALID_BODY;
+        m_removed++;
+
+        if(body != last)
+        {
+            for(int axis = 0; axis < 3; axis++)
+            {
+                m_min[axis][body] = m_min[axis][last];
+                m_max[axis][body] = m_max[axis][last];
+            }
+
+            m_entities[body] = m_entities[last];
+            m_ranks[body] = m_ranks[last];
+            m_order[m_ranks[body]] = body;
+            m_bodies[get_entity_index(m_entities[body])] = body;
+        }
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            m_min[axis].pop_back();
+            m_max[axis].pop_back();
+        }
+
+        m_entities.pop_back();
+        m_ranks.pop_back();
+        m_bodies[index] = INVALID_BODY;
+    }
+
+    bool SweepAndPrune::contains(EntityID a_id) const
+    {
+        std::uint32_t index = get_entity_index(a_id);
+
+        return index < m_bodies.size() && m_bodies[index] != INVALID_BODY && m_entities[m_bodies[index]] == a_id;
+    }
+
+    void SweepAndPrune::clear()
+    {
+        for(int axis = 0; axis < 3; axis++)
+        {
+            m_min[axis].clear();
+            m_max[axis].clear();
+        }
+
+        m_entities.clear();
+        m_bodies.clear();
+        m_order.clear();
+        m_ranks.clear();
+        m_pairs.clear();
+        m_removed = 0;
+        m_inserted = 0;
+    }
+
+    size_t SweepAndPrune::size() const
+    {
+        return m_entities.size();
+    }
+
+    const std::vector<BroadphasePair>& SweepAndPrune::update_pairs()
+    {
+        bool axis_changed = choose_axis();
+        sort_bodies(axis_changed || m_inserted * FULL_SORT_INSERTED_FRACTION > size());
+        gather_sorted();
+
+        size_t count = size();
+        m_range_pairs.resize((count + BROADPHASE_PAIR_GRAIN - 1) / BROADPHASE_PAIR_GRAIN);
+
+        auto range_func = [this](size_t a_begin, size_t a_end, size_t) {
+            for(size_t begin = a_begin; begin < a_end; begin += BROADPHASE_PAIR_GRAIN)
+            {
+                std::vector<BroadphasePair>& pairs = m_range_pairs[begin / BROADPHASE_PAIR_GRAIN];
+                pairs.clear();
+                find_pairs_in_range(begin, std::min(begin + BROADPHASE_PAIR_GRAIN, a_end), pairs);
+            }
+        };
+
+        TPool* pool = TPool::get_instance();
+        if(pool)
+        {
+            pool->parallel_for(count, BROADPHASE_PAIR_GRAIN, range_func);
+        }
+        else
+        {
+            range_func(0, count, 0);
+        }
+
+        size_t pairs_count = 0;
+        for(const std::vector<BroadphasePair>& pairs : m_range_pairs)
+        {
+            pairs_count += pairs.size();
+        }
+
+        m_pairs.clear();
+        m_pairs.reserve(pairs_count);
+        for(const std::vector<BroadphasePair>& pairs : m_range_pairs)
+        {
+            m_pairs.insert(m_pairs.end(), pairs.begin(), pairs.end());
+        }
+
+        return m_pairs;
+    }
+
+    const std::vector<BroadphasePair>& SweepAndPrune::get_pairs() const
+    {
+        return m_pairs;
+    }
+
+    int SweepAndPrune::get_sweep_axis() const
+    {
+        return m_axis;
+    }
+
+    bool SweepAndPrune::choose_axis()
+    {
+        size_t count = size();
+        if(count == 0)
+        {
+            return false;
+        }
+
+        double variance[3];
+        for(int axis = 0; axis < 3; axis++)
+        {
+            double sum = 0.0;
+            double squares = 0.0;
+
+            for(size_t body = 0; body < count; body++)
+            {
+                double center = 0.5 * (double(m_min[axis][body]) + double(m_max[axis][body]));
+                sum += center;
+                squares += center * center;
+            }
+
+            double mean = sum / double(count);
+            variance[axis] = squares / double(count) - mean * mean;
+        }
+
+        int best = static_cast<int>(std::max_element(variance, variance + 3) - variance);
+        if(best == m_axis || variance[best] <= variance[m_axis] * AXIS_SWITCH_RATIO)
+        {
+            return false;
+        }
+
+        m_axis = best;
+        return true;
+    }
+
+    //Insertion sort on keys gathered in the previous order, a body moving past k others costs k swaps.
+    void SweepAndPrune::sort_bodies(bool a_full)
+    {
+        if(m_removed > 0)
+        {
+            m_order.erase(std::remove(m_order.begin(), m_order.end(), INVALID_BODY), m_order.end());
+            m_removed = 0;
+        }
+
+        const std::vector<float>& min = m_min[m_axis];
+        size_t count = m_order.size();
+
+        if(a_full)
+        {
+            std::sort(m_order.begin(), m_order.end(), [&min](std::uint32_t a_first, std::uint32_t a_second) {
+                return min[a_first] < min[a_second];
+            });
+        }
+        else
+        {
+            m_keys.resize(count);
+            for(size_t i = 0; i < count; i++)
+            {
+                m_keys[i] = min[m_order[i]];
+            }
+
+            for(size_t i = 1; i < count; i++)
+            {
+                float key = m_keys[i];
+                std::uint32_t body = m_order[i];
+
+                size_t j = i;
+                for(; j > 0 && m_keys[j - 1] > key; j--)
+                {
+                    m_keys[j] = m_keys[j - 1];
+                    m_order[j] = m_order[j - 1];
+                }
+
+                m_keys[j] = key;
+                m_order[j] = body;
+            }
+        }
+
+        for(size_t i = 0; i < count; i++)
+        {
+            m_ranks[m_order[i]] = static_cast<std::uint32_t>(i);
+        }
+
+        m_inserted = 0;
+    }
+
+    void SweepAndPrune::gather_sorted()
+    {
+        size_t count = m_order.size();
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            int source = (m_axis + axis) % 3;
+            m_sorted_min[axis].resize(count);
+            m_sorted_max[axis].resize(count);
+
+            for(size_t i = 0; i < count; i++)
+            {
+                m_sorted_min[axis][i] = m_min[source][m_order[i]];
+                m_sorted_max[axis][i] = m_max[source][m_order[i]];
+            }
+        }
+
+        m_sorted_entities.resize(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            m_sorted_entities[i] = m_entities[m_order[i]];
+        }
+    }
+
+    //Boxes are inclusive, touching ones overlap. Candidates are tested four at a time with SSE2 when available,
+    //the sweep ends at the first one starting past the maximum of the swept box.
+    void SweepAndPrune::find_pairs_in_range(size_t a_begin, size_t a_end, std::vector<BroadphasePair>& a_out) const
+    {
+        const float* sweep_min = m_sorted_min[0].data();
+        const float* min_1 = m_sorted_min[1].data();
+        const float* max_1 = m_sorted_max[1].data();
+        const float* min_2 = m_sorted_min[2].data();
+        const float* max_2 = m_sorted_max[2].data();
+        size_t count = m_sorted_entities.size();
+
+        for(size_t i = a_begin; i < a_end; i++)
+        {
+            float box_sweep_max = m_sorted_max[0][i];
+            float box_min_1 = min_1[i];
+            float box_max_1 = max_1[i];
+            float box_min_2 = min_2[i];
+            float box_max_2 = max_2[i];
+            EntityID entity = m_sorted_entities[i];
+
+            size_t j = i + 1;
+
+#ifdef VIS_SIMD_SSE2
+            __m128 sweep_max_4 = _mm_set1_ps(box_sweep_max);
+            __m128 min_1_4 = _mm_set1_ps(box_min_1);
+            __m128 max_1_4 = _mm_set1_ps(box_max_1);
+            __m128 min_2_4 = _mm_set1_ps(box_min_2);
+            __m128 max_2_4 = _mm_set1_ps(box_max_2);
+
+            bool swept = false;
+            for(; j + 4 <= count; j += 4)
+            {
+                __m128 in_sweep = _mm_cmple_ps(_mm_loadu_ps(sweep_min + j), sweep_max_4);
+                __m128 overlap_1 = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(min_1 + j), max_1_4), _mm_cmpge_ps(_mm_loadu_ps(max_1 + j), min_1_4));
+                __m128 overlap_2 = _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(min_2 + j), max_2_4), _mm_cmpge_ps(_mm_loadu_ps(max_2 + j), min_2_4));
+
+                auto mask = static_cast<unsigned int>(_mm_movemask_ps(_mm_and_ps(in_sweep, _mm_and_ps(overlap_1, overlap_2))));
+                while(mask)
+                {
+                    a_out.push_back(make_pair(entity, m_sorted_entities[j + std::countr_zero(mask)]));
+                    mask &= mask - 1;
+                }
+
+                if(_mm_movemask_ps(in_sweep) != 0xF)
+                {
+                    swept = true;
+                    break;
+                }
+            }
+
+            if(swept)
+            {
+                continue;
+            }
+#endif
+
+            for(; j < count && sweep_min[j] <= box_sweep_max; j++)
+            {
+                if(min_1[j] <= box_max_1 && max_1[j] >= box_min_1 && min_2[j] <= box_max_2 && max_2[j] >= box_min_2)
+                {
+                    a_out.push_back(make_pair(entity, m_sorted_entities[j]));
+                }
+            }
+        }
+    }
+}
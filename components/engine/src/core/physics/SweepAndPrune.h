@@ -0,0 +1,85 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_SWEEPANDPRUNE_H
+#define MAIN_SWEEPANDPRUNE_H
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "Types.h"
+#include "math/Simd.h"
+#include "math/Bounds.h"
+
+#define BROADPHASE_PAIR_GRAIN 1024
+
+namespace vis
+{
+    //Bodies whose boxes overlap, m_first < m_second.
+    struct BroadphasePair
+    {
+        EntityID m_first;
+        EntityID m_second;
+    };
+
+    //Broadphase over axis aligned boxes of bodies. Boxes are sorted by their minimum along the axis where body
+    //centers vary the most, the sort starts from the order of the previous update so coherent motion only costs
+    //a few swaps. Every box is then swept against the following ones until their minimum passes its maximum.
+    //Boxes are kept per axis in structure of arrays layout, the sweep reads copies gathered in sorted order.
+    class SweepAndPrune
+    {
+    public:
+        SweepAndPrune();
+
+        //Inserts a_id or replaces its box when already in the broadphase.
+        void update(EntityID a_id, const AABB& a_box);
+        void remove(EntityID a_id);
+        bool contains(EntityID a_id) const;
+        void clear();
+        size_t size() const;
+
+        //Sorts bodies and rebuilds the pair list, pairs are generated on TPool. The list is ordered by the position
+        //of the first body along the sweep axis and stays valid until the next call.
+        const std::vector<BroadphasePair>& update_pairs();
+        const std::vector<BroadphasePair>& get_pairs() const;
+
+        //0, 1 or 2 for x, y or z, axis of the last sweep.
+        int get_sweep_axis() const;
+    private:
+        //Picks the axis of greatest variance of box centers, returns true when it differs from the current one.
+        bool choose_axis();
+        void sort_bodies(bool a_full);
+        void gather_sorted();
+        void find_pairs_in_range(size_t a_begin, size_t a_end, std::vector<BroadphasePair>& a_out) const;
+    private:
+        //Box of a body is m_min[axis][body] to m_max[axis][body], bodies are dense.
+        std::array<std::vector<float>, 3> m_min;
+        std::array<std::vector<float>, 3> m_max;
+        std::vector<EntityID>             m_entities;
+
+        //Body of every entity index, stale handles are told apart through m_entities.
+        std::vector<std::uint32_t>        m_bodies;
+
+        //Bodies in sweep order and position of every body in it. Removed bodies leave holes until the next sort.
+        std::vector<std::uint32_t>        m_order;
+        std::vector<std::uint32_t>        m_ranks;
+        std::vector<float>                m_keys;
+
+        //Boxes in sweep order, index 0 is the sweep axis and 1, 2 the other two.
+        std::array<std::vector<float>, 3> m_sorted_min;
+        std::array<std::vector<float>, 3> m_sorted_max;
+        std::vector<EntityID>             m_sorted_entities;
+
+        //Pairs of every range of BROADPHASE_PAIR_GRAIN bodies, concatenated in range order into m_pairs.
+        std::vector<std::vector<BroadphasePair>> m_range_pairs;
+        std::vector<BroadphasePair>              m_pairs;
+
+        size_t                            m_removed;
+        size_t                            m_inserted;
+        int                               m_axis;
+    };
+}
+
+#endif //MAIN_SWEEPANDPRUNE_H
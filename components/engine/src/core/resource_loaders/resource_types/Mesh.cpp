@@ -4,6 +4,9 @@
 
 #include "Mesh.h"
 
+#include <cmath>
+#include <algorithm>
+
 namespace vis
 {
 
@@ -12,6 +15,8 @@ namespace vis
         m_vertices = std::move(a_vertices);
         m_indices = std::move(a_indices);
         m_geometry_type = a_geometry_type;
+
+        compute_bounds();
     }
 
     const std::vector<Vertex>& Mesh::get_vertices() const
@@ -28,4 +33,43 @@ namespace vis
     {
         return m_geometry_type;
     }
+
+    const AABB& Mesh::get_aabb() const
+    {
+        return m_aabb;
+    }
+
+    const BoundingSphere& Mesh::get_bounding_sphere() const
+    {
+        return m_bounding_sphere;
+    }
+
+    //Sphere is centered in the box and reaches the furthest vertex, tighter than the box's circumscribed sphere.
+    void Mesh::compute_bounds()
+    {
+        m_aabb = AABB{ .m_min = glm::vec3(0.0f), .m_max = glm::vec3(0.0f) };
+        m_bounding_sphere = BoundingSphere{ .m_center = glm::vec3(0.0f), .m_radius = 0.0f };
+
+        if(m_vertices.empty())
+        {
+            return;
+        }
+
+        m_aabb.m_min = m_aabb.m_max = m_vertices.front().m_position;
+        for(const Vertex& vertex : m_vertices)
+        {
+            m_aabb.m_min = glm::min(m_aabb.m_min, vertex.m_position);
+            m_aabb.m_max = glm::max(m_aabb.m_max, vertex.m_position);
+        }
+
+        glm::vec3 center = (m_aabb.m_min + m_aabb.m_max) * 0.5f;
+        float radius_squared = 0.0f;
+        for(const Vertex& vertex : m_vertices)
+        {
+            glm::vec3 offset = vertex.m_position - center;
+            radius_squared = std::max(radius_squared, glm::dot(offset, offset));
+        }
+
+        m_bounding_sphere = BoundingSphere{ .m_center = center, .m_radius = std::sqrt(radius_squared) };
+    }
 }
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "glm/glm.hpp"
+#include "math/Bounds.h"
 
 namespace vis
 {
@@ -26,10 +27,18 @@ namespace vis
         const std::vector<Vertex>& get_vertices() const;
         const std::vector<unsigned int>& get_indices() const;
         unsigned int get_geometry_type() const;
+
+        //Bounds of vertex positions in model space, computed once when the mesh is created.
+        const AABB& get_aabb() const;
+        const BoundingSphere& get_bounding_sphere() const;
+    private:
+        void compute_bounds();
     private:
         std::vector<Vertex> m_vertices;
         std::vector<unsigned int> m_indices;
         unsigned int m_geometry_type;
+        AABB m_aabb;
+        BoundingSphere m_bounding_sphere;
     };
 }
 
@@ -22,7 +22,7 @@ namespace vis
 
     }
 
-    Scene::Scene(const std::string& a_name, std::set<std::uint16_t> a_entities)
+    Scene::Scene(const std::string& a_name, std::set<EntityID> a_entities)
     {
         m_name = a_name;
         m_entities = std::move(a_entities);
@@ -42,7 +42,7 @@ namespace vis
         }
     }
 
-    std::set<std::uint16_t>& Scene::get_entities()
+    std::set<EntityID>& Scene::get_entities()
     {
         return m_entities;
     }
@@ -52,19 +52,19 @@ namespace vis
         return m_name;
     }
 
-    void Scene::add_entity(std::uint16_t a_id)
+    void Scene::add_entity(EntityID a_id)
     {
         m_entities.insert(a_id);
     }
 
-    void Scene::remove_entity(std::uint16_t a_id)
+    void Scene::remove_entity(EntityID a_id)
     {
         m_entities.erase(a_id);
     }
 
     void Scene::add_entity(EntityType a_type)
     {
-        std::uint16_t e = MainManager::get_instance()->create_entity();
+        EntityID e = MainManager::get_instance()->create_entity();
         glm::vec3 scale(1.0f);
 
         if(a_type == EntityType::SPHERE)
@@ -72,6 +72,7 @@ namespace vis
             scale = glm::vec3(0.3f);
         }
 
+        MainManager::get_instance()->set_entity_type(e, a_type);
         MainManager::get_instance()->set_current_entity(e);
         m_entities.insert(e);
 
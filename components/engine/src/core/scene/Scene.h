@@ -16,17 +16,17 @@ namespace vis
     public:
         Scene();
         Scene(const std::string& a_name);
-        Scene(const std::string& a_name, std::set<std::uint16_t> a_entities);
+        Scene(const std::string& a_name, std::set<EntityID> a_entities);
 
         void on_load();
         void on_unload();
 
-        void add_entity(std::uint16_t a_id);
-        void remove_entity(std::uint16_t a_id);
+        void add_entity(EntityID a_id);
+        void remove_entity(EntityID a_id);
 
         void add_entity(EntityType a_type = EntityType::EMPTY);
 
-        std::set<std::uint16_t>& get_entities();
+        std::set<EntityID>& get_entities();
         const std::string&       get_name() const;
     private:
         std::string get_suffix_from_type(EntityType a_type);
@@ -34,7 +34,7 @@ namespace vis
         std::string m_name;
         std::string m_default_mesh_path;
 
-        std::set<std::uint16_t> m_entities;
+        std::set<EntityID> m_entities;
     };
 }
 
@@ -0,0 +1,520 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#include "SpatialHashGrid.h"
+#include "TPool.h"
+#include "Logger.h"
+
+#include <cmath>
+#include <algorithm>
+
+namespace vis
+{
+    namespace
+    {
+        constexpr std::uint32_t INVALID_CELL = UINT32_MAX;
+        constexpr size_t        MIN_TABLE_CAPACITY = 64;
+
+        //Empty cells are kept for entities coming back, the grid is compacted once they make up half of it.
+        constexpr size_t        MIN_EMPTY_CELLS_TO_COMPACT = 1024;
+
+        //Keeps float to int conversion defined for positions far outside any sane world.
+        constexpr float         MAX_CELL_COORD = 1.0e9f;
+    }
+
+    SpatialHashGrid::SpatialHashGrid(float a_cell_size)
+    {
+        if(!(a_cell_size > 0.0f))
+        {
+            LOG_ERROR("Spatial hash cell size has to be positive, got: {0}", a_cell_size);
+            a_cell_size = SPATIAL_HASH_DEFAULT_CELL_SIZE;
+        }
+
+        m_cell_size = a_cell_size;
+        m_inverse_cell_size = 1.0f / a_cell_size;
+        clear();
+    }
+
+    void SpatialHashGrid::update(EntityID a_id, const glm::vec3& a_position)
+    {
+        std::uint32_t index = get_entity_index(a_id);
+
+        if(index >= m_locations.size())
+        {
+            m_locations.resize(index + 1, Location{ .m_entity = NULL_ENTITY, .m_cell = INVALID_CELL, .m_entry = 0, .m_coords = glm::ivec3(0) });
+        }
+
+        glm::ivec3 coords = get_coords(a_position);
+        Location& location = m_locations[index];
+
+        if(location.m_cell != INVALID_CELL)
+        {
+            if(location.m_entity == a_id && location.m_coords == coords)
+            {
+                m_cells[location.m_cell].m_entries[location.m_entry].m_position = a_position;
+                return;
+            }
+
+            //Either crossed a cell border or the slot was recycled without removing the old entity.
+            remove_entry(location.m_cell, location.m_entry);
+            m_size--;
+        }
+
+        std::uint32_t cell = get_or_add_cell(coords);
+        auto& entries = m_cells[cell].m_entries;
+
+        if(entries.empty())
+        {
+            m_empty_cells--;
+        }
+
+        location = Location{ .m_entity = a_id, .m_cell = cell, .m_entry = static_cast<std::uint32_t>(entries.size()), .m_coords = coords };
+        entries.push_back(CellEntry{ .m_position = a_position, .m_entity = a_id });
+        m_size++;
+
+        compact_if_sparse();
+    }
+
+    void SpatialHashGrid::remove(EntityID a_id)
+    {
+        if(!contains(a_id))
+        {
+            return;
+        }
+
+        Location& location = m_locations[get_entity_index(a_id)];
+        remove_entry(location.m_cell, location.m_entry);
+        location.m_cell = INVALID_CELL;
+        m_size--;
+
+        compact_if_sparse();
+    }
+
+    bool SpatialHashGrid::contains(EntityID a_id) const
+    {
+        std::uint32_t index = get_entity_index(a_id);
+
+        return index < m_locations.size() && m_locations[index].m_entity == a_id && m_locations[index].m_cell != INVALID_CELL;
+    }
+
+    void SpatialHashGrid::clear()
+    {
+        m_cells.clear();
+        m_locations.clear();
+        m_table.assign(MIN_TABLE_CAPACITY, TableSlot{ .m_coords = glm::ivec3(0), .m_cell = INVALID_CELL });
+        m_size = 0;
+        m_empty_cells = 0;
+    }
+
+    void SpatialHashGrid::set_cell_size(float a_cell_size)
+    {
+        if(!(a_cell_size > 0.0f))
+        {
+            LOG_ERROR("Spatial hash cell size has to be positive, got: {0}", a_cell_size);
+            return;
+        }
+
+        m_cell_size = a_cell_size;
+        m_inverse_cell_size = 1.0f / a_cell_size;
+        clear();
+    }
+
+    float SpatialHashGrid::get_cell_size() const
+    {
+        return m_cell_size;
+    }
+
+    size_t SpatialHashGrid::size() const
+    {
+        return m_size;
+    }
+
+    void SpatialHashGrid::query_radius(const glm::vec3& a_center, float a_radius, std::vector<EntityID>& a_out) const
+    {
+        if(a_radius < 0.0f)
+        {
+            return;
+        }
+
+        float radius_squared = a_radius * a_radius;
+        glm::vec3 extent(a_radius);
+
+        auto overlaps = [&](const glm::ivec3& a_coords) {
+            return get_cell_distance_squared(a_coords, a_center) <= radius_squared;
+        };
+
+        for_each_cell(get_coords(a_center - extent), get_coords(a_center + extent), overlaps, [&](const Cell& a_cell) {
+            for(const CellEntry& entry : a_cell.m_entries)
+            {
+                glm::vec3 offset = entry.m_position - a_center;
+
+                if(glm::dot(offset, offset) <= radius_squared)
+                {
+                    a_out.push_back(entry.m_entity);
+                }
+            }
+        });
+    }
+
+    void SpatialHashGrid::query_aabb(const AABB& a_box, std::vector<EntityID>& a_out) const
+    {
+        auto overlaps = [](const glm::ivec3&) {
+            return true;
+        };
+
+        for_each_cell(get_coords(a_box.m_min), get_coords(a_box.m_max), overlaps, [&](const Cell& a_cell) {
+            for(const CellEntry& entry : a_cell.m_entries)
+            {
+                if(glm::all(glm::greaterThanEqual(entry.m_position, a_box.m_min)) && glm::all(glm::lessThanEqual(entry.m_position, a_box.m_max)))
+                {
+                    a_out.push_back(entry.m_entity);
+                }
+            }
+        });
+    }
+
+    //Visits cells in growing shells around the center cell. Cells further than the furthest of the best a_count found
+    //so far are not probed, the search stops once a whole shell is.
+    void SpatialHashGrid::query_nearest(const glm::vec3& a_center, size_t a_count, float a_max_distance, std::vector<EntityID>& a_out) const
+    {
+        if(a_count == 0 || m_size == 0 || a_max_distance < 0.0f)
+        {
+            return;
+        }
+
+        using Candidate = std::pair<float, EntityID>;
+        std::vector<Candidate> best;
+        best.reserve(a_count);
+
+        float max_distance_squared = a_max_distance * a_max_distance;
+        auto get_limit = [&]() {
+            return best.size() == a_count ? best.front().first : max_distance_squared;
+        };
+
+        auto visit = [&](const Cell& a_cell) {
+            for(const CellEntry& entry : a_cell.m_entries)
+            {
+                glm::vec3 offset = entry.m_position - a_center;
+                float distance_squared = glm::dot(offset, offset);
+
+                if(distance_squared > get_limit())
+                {
+                    continue;
+                }
+
+                if(best.size() < a_count)
+                {
+                    best.emplace_back(distance_squared, entry.m_entity);
+                    std::push_heap(best.begin(), best.end());
+                }
+                else if(distance_squared < best.front().first)
+                {
+                    std::pop_heap(best.begin(), best.end());
+                    best.back() = Candidate(distance_squared, entry.m_entity);
+                    std::push_heap(best.begin(), best.end());
+                }
+            }
+        };
+
+        glm::ivec3 center = get_coords(a_center);
+        size_t visited_cells = 0;
+
+        for(int shell = 0; ; shell++)
+        {
+            //Distance to the closest face of the cube formed by the previous shells bounds every cell of this one.
+            glm::vec3 low = a_center - glm::vec3(center - glm::ivec3(shell - 1)) * m_cell_size;
+            glm::vec3 high = glm::vec3(center + glm::ivec3(shell)) * m_cell_size - a_center;
+            float bound = shell > 0 ? std::max(0.0f, std::min(glm::min(low.x, glm::min(low.y, low.z)), glm::min(high.x, glm::min(high.y, high.z)))) : 0.0f;
+
+            if(bound * bound > get_limit())
+            {
+                break;
+            }
+
+            //Shells outgrow the grid in sparse worlds, finish by looking at every cell once.
+            size_t side = 2 * static_cast<size_t>(shell) + 1;
+            size_t shell_cells = shell > 0 ? side * side * side - (side - 2) * (side - 2) * (side - 2) : 1;
+
+            if(visited_cells + shell_cells > m_cells.size())
+            {
+                best.clear();
+                for(const Cell& cell : m_cells)
+                {
+                    visit(cell);
+                }
+                break;
+            }
+
+            visited_cells += shell_cells;
+
+            for(int x = -shell; x <= shell; x++)
+            {
+                for(int y = -shell; y <= shell; y++)
+                {
+                    bool on_face = x == -shell || x == shell || y == -shell || y == shell;
+                    int step = on_face ? 1 : std::max(2 * shell, 1);
+
+                    for(int z = -shell; z <= shell; z += step)
+                    {
+                        glm::ivec3 coords = center + glm::ivec3(x, y, z);
+
+                        if(get_cell_distance_squared(coords, a_center) > get_limit())
+                        {
+                            continue;
+                        }
+
+                        const Cell* cell = find_cell(coords);
+
+                        if(cell)
+                        {
+                            visit(*cell);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        for(const Candidate& candidate : best)
+        {
+            a_out.push_back(candidate.second);
+        }
+    }
+
+    void SpatialHashGrid::query_radius_batch(const glm::vec3* a_centers, size_t a_count, float a_radius, std::vector<std::vector<EntityID>>& a_results) const
+    {
+        run_batch(a_count, a_results, [&](size_t a_index, std::vector<EntityID>& a_out) {
+            query_radius(a_centers[a_index], a_radius, a_out);
+        });
+    }
+
+    void SpatialHashGrid::query_aabb_batch(const AABB* a_boxes, size_t a_count, std::vector<std::vector<EntityID>>& a_results) const
+    {
+        run_batch(a_count, a_results, [&](size_t a_index, std::vector<EntityID>& a_out) {
+            query_aabb(a_boxes[a_index], a_out);
+        });
+    }
+
+    void SpatialHashGrid::query_nearest_batch(const glm::vec3* a_centers, size_t a_count, size_t a_nearest_count, float a_max_distance, std::vector<std::vector<EntityID>>& a_results) const
+    {
+        run_batch(a_count, a_results, [&](size_t a_index, std::vector<EntityID>& a_out) {
+            query_nearest(a_centers[a_index], a_nearest_count, a_max_distance, a_out);
+        });
+    }
+
+    glm::ivec3 SpatialHashGrid::get_coords(const glm::vec3& a_position) const
+    {
+        glm::vec3 scaled = glm::clamp(glm::floor(a_position * m_inverse_cell_size), glm::vec3(-MAX_CELL_COORD), glm::vec3(MAX_CELL_COORD));
+
+        return glm::ivec3(scaled);
+    }
+
+    float SpatialHashGrid::get_cell_distance_squared(const glm::ivec3& a_coords, const glm::vec3& a_point) const
+    {
+        glm::vec3 cell_min = glm::vec3(a_coords) * m_cell_size;
+        glm::vec3 offset = glm::max(glm::max(cell_min - a_point, a_point - (cell_min + m_cell_size)), glm::vec3(0.0f));
+
+        return glm::dot(offset, offset);
+    }
+
+    const SpatialHashGrid::Cell* SpatialHashGrid::find_cell(const glm::ivec3& a_coords) const
+    {
+        size_t mask = m_table.size() - 1;
+
+        for(size_t slot = hash(a_coords) & mask; m_table[slot].m_cell != INVALID_CELL; slot = (slot + 1) & mask)
+        {
+            if(m_table[slot].m_coords == a_coords)
+            {
+                return &m_cells[m_table[slot].m_cell];
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::uint32_t SpatialHashGrid::get_or_add_cell(const glm::ivec3& a_coords)
+    {
+        const Cell* cell = find_cell(a_coords);
+
+        if(cell)
+        {
+            return static_cast<std::uint32_t>(cell - m_cells.data());
+        }
+
+        m_cells.push_back(Cell{ .m_coords = a_coords, .m_entries = {} });
+        m_empty_cells++;
+
+        //Load factor stays at or below one half so probe chains stay short.
+        if(m_cells.size() * 2 > m_table.size())
+        {
+            rehash(m_table.size() * 2);
+        }
+        else
+        {
+            insert_cell_index(static_cast<std::uint32_t>(m_cells.size() - 1));
+        }
+
+        return static_cast<std::uint32_t>(m_cells.size() - 1);
+    }
+
+    //Last entry of the cell takes the place of the removed one.
+    void SpatialHashGrid::remove_entry(std::uint32_t a_cell, std::uint32_t a_entry)
+    {
+        auto& entries = m_cells[a_cell].m_entries;
+
+        if(a_entry + 1 != entries.size())
+        {
+            entries[a_entry] = entries.back();
+            m_locations[get_entity_index(entries[a_entry].m_entity)].m_entry = a_entry;
+        }
+
+        entries.pop_back();
+
+        if(entries.empty())
+        {
+            m_empty_cells++;
+        }
+    }
+
+    void SpatialHashGrid::insert_cell_index(std::uint32_t a_cell)
+    {
+        size_t mask = m_table.size() - 1;
+        const glm::ivec3& coords = m_cells[a_cell].m_coords;
+        size_t slot = hash(coords) & mask;
+
+        while(m_table[slot].m_cell != INVALID_CELL)
+        {
+            slot = (slot + 1) & mask;
+        }
+
+        m_table[slot] = TableSlot{ .m_coords = coords, .m_cell = a_cell };
+    }
+
+    void SpatialHashGrid::rehash(size_t a_capacity)
+    {
+        m_table.assign(std::max(a_capacity, MIN_TABLE_CAPACITY), TableSlot{ .m_coords = glm::ivec3(0), .m_cell = INVALID_CELL });
+
+        for(std::uint32_t cell = 0; cell < m_cells.size(); cell++)
+        {
+            insert_cell_index(cell);
+        }
+    }
+
+    void SpatialHashGrid::compact_if_sparse()
+    {
+        if(m_empty_cells < MIN_EMPTY_CELLS_TO_COMPACT || m_empty_cells * 2 < m_cells.size())
+        {
+            return;
+        }
+
+        std::vector<Cell> cells;
+        cells.reserve(m_cells.size() - m_empty_cells);
+
+        for(Cell& cell : m_cells)
+        {
+            if(cell.m_entries.empty())
+            {
+                continue;
+            }
+
+            for(const CellEntry& entry : cell.m_entries)
+            {
+                m_locations[get_entity_index(entry.m_entity)].m_cell = static_cast<std::uint32_t>(cells.size());
+            }
+
+            cells.push_back(std::move(cell));
+        }
+
+        m_cells = std::move(cells);
+        m_empty_cells = 0;
+
+        size_t capacity = MIN_TABLE_CAPACITY;
+        while(capacity < m_cells.size() * 2)
+        {
+            capacity *= 2;
+        }
+
+        rehash(capacity);
+    }
+
+    //Boxes spanning more cells than the grid has are answered by walking the cells instead of probing for them.
+    template<typename O, typename F>
+    void SpatialHashGrid::for_each_cell(const glm::ivec3& a_min, const glm::ivec3& a_max, O&& a_overlaps, F&& a_func) const
+    {
+        //In doubles, the cell count of a huge box overflows any integer.
+        glm::dvec3 extent = glm::dvec3(a_max) - glm::dvec3(a_min) + glm::dvec3(1.0);
+
+        if(glm::any(glm::lessThan(extent, glm::dvec3(1.0))))
+        {
+            return;
+        }
+
+        if(extent.x * extent.y * extent.z > static_cast<double>(m_cells.size()))
+        {
+            for(const Cell& cell : m_cells)
+            {
+                if(glm::all(glm::greaterThanEqual(cell.m_coords, a_min)) && glm::all(glm::lessThanEqual(cell.m_coords, a_max)) && a_overlaps(cell.m_coords))
+                {
+                    a_func(cell);
+                }
+            }
+
+            return;
+        }
+
+        for(int x = a_min.x; x <= a_max.x; x++)
+        {
+            for(int y = a_min.y; y <= a_max.y; y++)
+            {
+                for(int z = a_min.z; z <= a_max.z; z++)
+                {
+                    glm::ivec3 coords(x, y, z);
+                    const Cell* cell = a_overlaps(coords) ? find_cell(coords) : nullptr;
+
+                    if(cell)
+                    {
+                        a_func(*cell);
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename F>
+    void SpatialHashGrid::run_batch(size_t a_count, std::vector<std::vector<EntityID>>& a_results, F&& a_query) const
+    {
+        a_results.resize(a_count);
+
+        auto range_func = [&a_results, &a_query](size_t a_begin, size_t a_end, size_t) {
+            for(size_t i = a_begin; i < a_end; i++)
+            {
+                a_results[i].clear();
+                a_query(i, a_results[i]);
+            }
+        };
+
+        TPool* pool = TPool::get_instance();
+        if(!pool)
+        {
+            range_func(0, a_count, 0);
+            return;
+        }
+
+        pool->parallel_for(a_count, SPATIAL_QUERY_GRAIN, range_func);
+    }
+
+    size_t SpatialHashGrid::hash(const glm::ivec3& a_coords)
+    {
+        std::uint64_t key = static_cast<std::uint64_t>(static_cast<std::uint32_t>(a_coords.x)) * 0x9E3779B97F4A7C15ull
+                          ^ static_cast<std::uint64_t>(static_cast<std::uint32_t>(a_coords.y)) * 0xC2B2AE3D27D4EB4Full
+                          ^ static_cast<std::uint64_t>(static_cast<std::uint32_t>(a_coords.z)) * 0x165667B19E3779F9ull;
+
+        //Products only carry low bits upwards, the finalizer mixes high bits back into the ones the table mask keeps.
+        key ^= key >> 33;
+        key *= 0xFF51AFD7ED558CCDull;
+        key ^= key >> 33;
+
+        return static_cast<size_t>(key);
+    }
+}
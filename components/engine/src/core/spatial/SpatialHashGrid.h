@@ -0,0 +1,109 @@
+//
+// Created by BlackFlage on 18.10.2026.
+//
+
+#ifndef MAIN_SPATIALHASHGRID_H
+#define MAIN_SPATIALHASHGRID_H
+
+#include <vector>
+#include <cstdint>
+
+#include "Types.h"
+#include "math/Bounds.h"
+#include "glm/glm.hpp"
+
+#define SPATIAL_HASH_DEFAULT_CELL_SIZE 8.0f
+#define SPATIAL_QUERY_GRAIN 64
+
+namespace vis
+{
+    //Points of entities bucketed into cubic cells of a hashed, unbounded grid. Every cell keeps its entities
+    //together with their positions so queries read cells linearly and never look entities up. Moving an entity
+    //inside its cell rewrites one entry, crossing a cell border moves it between two cells.
+    //Queries may run concurrently with each other, never with insert, update or remove.
+    class SpatialHashGrid
+    {
+    public:
+        explicit SpatialHashGrid(float a_cell_size = SPATIAL_HASH_DEFAULT_CELL_SIZE);
+
+        //Inserts a_id or moves it to a_position when already in the grid.
+        void update(EntityID a_id, const glm::vec3& a_position);
+        void remove(EntityID a_id);
+        bool contains(EntityID a_id) const;
+        void clear();
+
+        //Drops every entity. Cells about twice the radius of the most common query keep probes and scanned entities low.
+        void set_cell_size(float a_cell_size);
+        float get_cell_size() const;
+        size_t size() const;
+
+        //Results are appended to a_out in no particular order.
+        void query_radius(const glm::vec3& a_center, float a_radius, std::vector<EntityID>& a_out) const;
+        void query_aabb(const AABB& a_box, std::vector<EntityID>& a_out) const;
+
+        //Up to a_count entities closest to a_center and not further than a_max_distance, nearest first.
+        void query_nearest(const glm::vec3& a_center, size_t a_count, float a_max_distance, std::vector<EntityID>& a_out) const;
+
+        //One query per element, a_results[i] is overwritten with the result of the i-th one. Spread on TPool.
+        void query_radius_batch(const glm::vec3* a_centers, size_t a_count, float a_radius, std::vector<std::vector<EntityID>>& a_results) const;
+        void query_aabb_batch(const AABB* a_boxes, size_t a_count, std::vector<std::vector<EntityID>>& a_results) const;
+        void query_nearest_batch(const glm::vec3* a_centers, size_t a_count, size_t a_nearest_count, float a_max_distance, std::vector<std::vector<EntityID>>& a_results) const;
+    private:
+        struct CellEntry
+        {
+            glm::vec3 m_position;
+            EntityID  m_entity;
+        };
+
+        struct Cell
+        {
+            glm::ivec3             m_coords;
+            std::vector<CellEntry> m_entries;
+        };
+
+        //Coordinates are kept next to the cell index so probing never touches m_cells.
+        struct TableSlot
+        {
+            glm::ivec3    m_coords;
+            std::uint32_t m_cell;
+        };
+
+        //Where the entity of an index is stored, m_entity tells stale handles apart.
+        struct Location
+        {
+            EntityID      m_entity;
+            std::uint32_t m_cell;
+            std::uint32_t m_entry;
+            glm::ivec3    m_coords;
+        };
+
+        glm::ivec3 get_coords(const glm::vec3& a_position) const;
+        const Cell* find_cell(const glm::ivec3& a_coords) const;
+        std::uint32_t get_or_add_cell(const glm::ivec3& a_coords);
+        void remove_entry(std::uint32_t a_cell, std::uint32_t a_entry);
+        void insert_cell_index(std::uint32_t a_cell);
+        void rehash(size_t a_capacity);
+        void compact_if_sparse();
+
+        float get_cell_distance_squared(const glm::ivec3& a_coords, const glm::vec3& a_point) const;
+
+        //Calls a_func for cells between a_min and a_max, both inclusive, for which a_overlaps(coords) holds.
+        template<typename O, typename F>
+        void for_each_cell(const glm::ivec3& a_min, const glm::ivec3& a_max, O&& a_overlaps, F&& a_func) const;
+
+        template<typename F>
+        void run_batch(size_t a_count, std::vector<std::vector<EntityID>>& a_results, F&& a_query) const;
+
+        static size_t hash(const glm::ivec3& a_coords);
+    private:
+        std::vector<Cell>          m_cells;
+        std::vector<TableSlot>     m_table;
+        std::vector<Location>      m_locations;
+        size_t                     m_size;
+        size_t                     m_empty_cells;
+        float                      m_cell_size;
+        float                      m_inverse_cell_size;
+    };
+}
+
+#endif //MAIN_SPATIALHASHGRID_H
@@ -122,6 +122,11 @@ namespace vis
         m_camera = a_camera;
     }
 
+    Camera* Renderer::get_camera()
+    {
+        return m_camera;
+    }
+
     void Renderer::set_shader(Shader *shader)
     {
         m_shader = shader;
@@ -26,6 +26,7 @@ namespace vis
         static void end();
 
         static void set_camera(Camera* m_camera);
+        static Camera* get_camera();
         static void set_shader(Shader* shader);
 
         static void submit_data(const MeshRender& a_mesh);
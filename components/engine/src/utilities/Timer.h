@@ -14,27 +14,38 @@ namespace vis
     public:
         Timer()
         {
-            m_last_stamp = std::chrono::high_resolution_clock::now();
-            m_beginning = std::chrono::high_resolution_clock::now();
+            m_last_stamp = std::chrono::steady_clock::now();
+            m_beginning = m_last_stamp;
         }
 
+        //Seconds, at the resolution of steady_clock.
         float get_delta_time()
         {
-            auto now = std::chrono::high_resolution_clock::now();
+            auto now = std::chrono::steady_clock::now();
 
-            return (float)std::chrono::duration_cast<std::chrono::milliseconds>(now - m_last_stamp).count() / 1000.0f;
+            return std::chrono::duration<float>(now - m_last_stamp).count();
         }
 
         float get_time_passed()
         {
-            auto now = std::chrono::high_resolution_clock::now();
+            auto now = std::chrono::steady_clock::now();
 
-            return (float)std::chrono::duration_cast<std::chrono::milliseconds>(now - m_beginning).count() / 1000.0f;
+            return std::chrono::duration<float>(now - m_beginning).count();
         }
 
         void new_time_stamp()
         {
-            m_last_stamp = std::chrono::high_resolution_clock::now();
+            m_last_stamp = std::chrono::steady_clock::now();
+        }
+
+        //Seconds since the last stamp, stamps now. Reading and stamping at the same instant loses no time between calls.
+        double lap()
+        {
+            auto now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(now - m_last_stamp).count();
+            m_last_stamp = now;
+
+            return elapsed;
         }
 
     private: